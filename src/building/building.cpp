@@ -1101,7 +1101,7 @@ void building_impl::on_place_checks() {
 }
 
 void building_impl::update_graphic() {
-    base.minimap_anim = anim("minimap");
+    base.minimap_anim = anim(XSTR("minimap"));
 }
 
 void building_impl::update_day() {
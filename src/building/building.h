@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <algorithm>
+#include <type_traits>
 
 class io_buffer;
 class figure;
@@ -432,6 +433,14 @@ public:
             bool ferries;
         } updates;
 
+        // which per-period hooks the impl class overrides, see model_t.
+        // types without their own model keep the defaults from building_impl
+        struct {
+            bool on_tick;
+            bool update_day;
+            bool update_month;
+        } hooks;
+
         struct {
             bool meadow;
             bool rock;
@@ -765,6 +774,22 @@ typedef void (*load_building_static_params_cb)();
 using BuildingCtorIterator = FuncLinkedList<create_building_function_cb>;
 using BuildingParamIterator = FuncLinkedList<load_building_static_params_cb>;
 
+// class the hook of T resolves to, building_impl means T keeps the default one
+template<typename C> C *hook_owner(void (C::*)());
+template<typename C> C *hook_owner(void (C::*)(bool));
+
+// T::hook may be hidden by an overload with other arguments, count that as overridden
+#define BUILDING_HOOK_OVERRIDE_TRAIT(hook)                                                                     \
+    template<typename T, typename = void> struct overrides_##hook : std::true_type {};                         \
+    template<typename T> struct overrides_##hook<T, std::void_t<decltype(hook_owner(&T::hook))>>               \
+        : std::bool_constant<!std::is_same_v<decltype(hook_owner(&T::hook)), building_impl *>> {};
+
+BUILDING_HOOK_OVERRIDE_TRAIT(on_tick)
+BUILDING_HOOK_OVERRIDE_TRAIT(update_day)
+BUILDING_HOOK_OVERRIDE_TRAIT(update_graphic)
+BUILDING_HOOK_OVERRIDE_TRAIT(update_month)
+#undef BUILDING_HOOK_OVERRIDE_TRAIT
+
 template<typename T>
 struct model_t : public building_impl::static_params {
     using building_type = T;
@@ -774,6 +799,9 @@ struct model_t : public building_impl::static_params {
     model_t() {
         name = CLSID;
         type = TYPE;
+        hooks.on_tick = overrides_on_tick<T>::value;
+        hooks.update_day = overrides_update_day<T>::value || overrides_update_graphic<T>::value; // default day only refreshes the graphic
+        hooks.update_month = overrides_update_month<T>::value;
 
         static BuildingCtorIterator ctor_handler(&create);
         static BuildingParamIterator static_params_handler(&static_params_load);
@@ -230,14 +230,14 @@ void building_bandstand::draw_shows_musicians(painter &ctx, vec2i pixel, int dir
     switch (direction) {
     case 0:
     {
-        const animation_t &ranim = anim("musician_sn");
+        const animation_t &ranim = anim(XSTR("musician_sn"));
         building_draw_normal_anim(ctx, pixel, &base, tile(), ranim, color_mask);
     }
     break;
 
     case 1:
     {
-        const animation_t &ranim = anim("musician_we");
+        const animation_t &ranim = anim(XSTR("musician_we"));
         building_draw_normal_anim(ctx, pixel, &base, tile(), ranim, color_mask);
     }
     break;
@@ -25,6 +25,7 @@
 #include "construction/build_planner.h"
 #include "city/city_labor.h"
 #include "figure/figure.h"
+#include "core/random.h"
 
 building_booth::static_params booth_m;
 
@@ -76,7 +77,7 @@ void building_booth::update_day() {
 
 void building_booth::update_month() {
     auto &d = runtime_data();
-    d.play_index = std::rand() % 10;
+    d.play_index = random_sim_between(0, 10);
 }
 
 void building_booth::on_place(int orientation, int variant) {
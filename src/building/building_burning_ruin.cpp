@@ -77,10 +77,10 @@ std::pair<int, tile2i> building_burning_ruin::get_closest_from(tile2i tile) {
 // be executed in on_create()
 void building_burning_ruin::on_create(int orientation) {
     building_impl::on_create(orientation);
-    base.fire_duration = (rand() % 128) + 120;
+    base.fire_duration = random_sim_between(0, 128) + 120;
     base.state = BUILDING_STATE_VALID;
 
-    uint8_t random = rand() % current_params().fire_animations;
+    uint8_t random = random_sim_between(0, current_params().fire_animations);
     xstring anim_name; anim_name.printf("fire%d", random);
     set_animation(anim_name);
 
@@ -141,7 +141,7 @@ bool building_burning_ruin::update() {
         return true;
     }
 
-    base.fire_duration -= rand() % 16;
+    base.fire_duration -= random_sim_between(0, 16);
     if (base.fire_duration <= 0) {
         game_undo_disable();
         base.state = BUILDING_STATE_RUBBLE;
@@ -96,12 +96,12 @@ void building_entertainment::place_latch_on_venue(e_building_type type, int dx,
 
     case BUILDING_BANDSTAND:
         if (main_venue) {
-            int stand_sn_s = anim("stand_sn_s").first_img();
+            int stand_sn_s = anim(XSTR("stand_sn_s")).first_img();
             d.latched_venue_main_grid_offset = point.grid_offset();
             int offset = bandstand_main_img_offset(orientation);
             map_image_set(point, stand_sn_s + offset);
         } else {
-            int stand_sn_s = anim("stand_sn_s").first_img();
+            int stand_sn_s = anim(XSTR("stand_sn_s")).first_img();
             d.latched_venue_add_grid_offset = point.grid_offset();
             int offset = bandstand_add_img_offset(orientation);
             map_image_set(point, stand_sn_s + offset);
@@ -102,7 +102,7 @@ void building_festival_square::update_map_orientation(int map_orientation) {
         return;
     }
 
-    int plaza_image_id = anim("square").first_img();
+    int plaza_image_id = anim(XSTR("square")).first_img();
     tile2i btile(runtime_data().booth_corner_grid_offset);
     map_add_venue_plaza_tiles(id(), size(), btile, plaza_image_id, true);
 }
@@ -179,7 +179,7 @@ int building_granary_for_storing(tile2i tile, e_resource resource, int distance_
 
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (building_id i : g_storage_index.granaries_accepting(road_network_id, resource)) {
         building_granary* granary = building_get(i)->dcast_granary();
         if (!granary || !granary->is_valid())
             continue;
@@ -233,7 +233,7 @@ int building_getting_granary_for_storing(tile2i tile, e_resource resource, int d
 
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (building_id i : g_storage_index.granaries_on_network(road_network_id)) {
         building_granary* granary = building_get(i)->dcast_granary();
         if (!granary || !granary->is_valid())
             continue;
@@ -270,32 +270,37 @@ int building_granary::better_getting_storage() {
     int min_dist = INFINITE;
     int min_building_id = 0;
 
-    for (auto &b : city_buildings()) {
-        building_storage* dest = b.dcast_storage();
-
-        if (!game_features::gameplay_change_getting_granaries_go_offroad) {
-            if (dest->road_network() != road_network()) {
+    for (const auto *candidates : {&g_storage_index.all_granaries(), &g_storage_index.all_yards()}) {
+        for (building_id bid : *candidates) {
+            building_storage* dest = building_get(bid)->dcast_storage();
+            if (!dest || !dest->is_valid()) {
                 continue;
             }
-        }
 
-        int amount_gettable = 0;
-        for (const auto &r : resource_list::foods) {
-            if ((is_getting(r.type)) && !dest->is_gettable(r.type)) {
-                amount_gettable = std::max(dest->amount(r.type), amount_gettable);
+            if (!game_features::gameplay_change_getting_granaries_go_offroad) {
+                if (dest->road_network() != road_network()) {
+                    continue;
+                }
             }
-        }
 
-        if (amount_gettable > 0) {
-            int dist = calc_distance_with_penalty(vec2i(tilex() + 1, tiley() + 1), vec2i(dest->tilex() + 1, dest->tiley() + 1), 
-                                                  distance_from_entry(), dest->distance_from_entry());
-            if (amount_gettable <= 400) {
-                dist *= 2; // penalty for less food
+            int amount_gettable = 0;
+            for (const auto &r : resource_list::foods) {
+                if ((is_getting(r.type)) && !dest->is_gettable(r.type)) {
+                    amount_gettable = std::max(dest->amount(r.type), amount_gettable);
+                }
             }
 
-            if (dist < min_dist) {
-                min_dist = dist;
-                min_building_id = dest->id();
+            if (amount_gettable > 0) {
+                int dist = calc_distance_with_penalty(vec2i(tilex() + 1, tiley() + 1), vec2i(dest->tilex() + 1, dest->tiley() + 1), 
+                                                      distance_from_entry(), dest->distance_from_entry());
+                if (amount_gettable <= 400) {
+                    dist *= 2; // penalty for less food
+                }
+
+                if (dist < min_dist) {
+                    min_dist = dist;
+                    min_building_id = dest->id();
+                }
             }
         }
     }
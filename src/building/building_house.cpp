@@ -395,7 +395,7 @@ void building_house::merge_impl() {
     }
     int image_id = house_image_group<false>(house_level()) + 4;
 
-    if (anim("house").offset) {
+    if (anim(XSTR("house")).offset) {
         image_id += 1;
     }
 
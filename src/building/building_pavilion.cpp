@@ -17,6 +17,7 @@
 #include "grid/orientation.h"
 #include "grid/building_tiles.h"
 #include "figure/figure.h"
+#include "core/random.h"
 
 building_pavilion::static_params pavilion_m;
 
@@ -100,7 +101,7 @@ void building_pavilion::on_create(int orientation) {
 }
 
 void building_pavilion::update_month() {
-    runtime_data().play_index = std::rand() % 10;
+    runtime_data().play_index = random_sim_between(0, 10);
 }
 
 void building_pavilion::update_day() {
@@ -215,7 +216,7 @@ void building_pavilion::update_map_orientation(int map_orientation) {
         return;
     }
 
-    int plaza_image_id = anim("square").first_img();
+    int plaza_image_id = anim(XSTR("square")).first_img();
     tile2i btile(runtime_data().booth_corner_grid_offset);
     map_add_venue_plaza_tiles(id(), size(), btile, plaza_image_id, true);
 }
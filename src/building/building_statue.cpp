@@ -13,6 +13,7 @@
 #include "window/building/common.h"
 #include "sound/sound_building.h"
 #include "core/svector.h"
+#include "core/random.h"
 #include "grid/terrain.h"
 #include "grid/building_tiles.h"
 #include "io/io_buffer.h"
@@ -98,7 +99,7 @@ void building_statue::on_create(int o) {
 
     auto &d = runtime_data();
     d.variant = g_city_planner.building_variant;
-    d.statue_offset = rand() % 4;
+    d.statue_offset = random_sim_between(0, 4);
 }
 
 void building_statue::on_place_update_tiles(int orientation, int variant) {
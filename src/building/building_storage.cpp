@@ -1,7 +1,12 @@
 #include "building_storage.h"
 
 #include "building/building.h"
+#include "building/building_granary.h"
+#include "building/building_storage_room.h"
+#include "building/building_storage_yard.h"
 #include "building/rotation.h"
+#include "city/city_buildings.h"
+#include "core/profiler.h"
 #include "core/object_property.h"
 #include "city/city.h"
 
@@ -51,6 +56,7 @@ int building_storage_create(int building_type) {
         if (!g_storages[i].in_use) {
             memset(&g_storages[i], 0, sizeof(storage_t));
             g_storages[i].in_use = 1;
+            g_storage_index.invalidate();
 
             // default settings for Pharaoh
             for (int r = 0; r < 36; r++) {
@@ -89,11 +95,13 @@ int building_storage_restore(int storage_id) {
         return 0;
     }
     g_storages[storage_id].in_use = 1;
+    g_storage_index.invalidate();
     return storage_id;
 }
 
 void building_storage_delete(int storage_id) {
     g_storages[storage_id].in_use = 0;
+    g_storage_index.invalidate();
 }
 
 storage_t backup_settings;
@@ -123,6 +131,7 @@ void storage_settings_backup_check() {
             }
 
             g_storages[backup_storage_id].storage = backup_settings;
+            g_storage_index.invalidate();
             storage_settings_backup_reset();
             window_city_show();
         });
@@ -147,6 +156,7 @@ void building_storage_toggle_empty_all(int storage_id) {
     for (auto &state : storage.resource_state) {
         state = STORAGE_STATE_PHARAOH_EMPTY;
     }
+    g_storage_index.invalidate();
 }
 
 void building_storage_cycle_resource_state(int storage_id, int resource_id, bool backwards) {
@@ -172,6 +182,7 @@ void building_storage_cycle_resource_state(int storage_id, int resource_id, bool
     }
 
     g_storages[storage_id].storage.resource_state[resource_id] = state;
+    g_storage_index.invalidate();
 }
 
 void building_storage::set_permission(int p) {
@@ -237,6 +248,7 @@ void building_storage_accept_none(int storage_id) {
     for (auto &state: storage.resource_state) {
         state = STORAGE_STATE_PHARAOH_REFUSE;
     }
+    g_storage_index.invalidate();
 }
 
 void building_storage_load_state(buffer* buf) {
@@ -262,8 +274,101 @@ io_buffer* iob_building_storages = new io_buffer([](io_buffer* iob, size_t versi
         }
         //        iob->bind____skip(144); // ?????
     }
+    g_storage_index.invalidate();
 });
 
+building_storage_index_t g_storage_index;
+
+static bool storage_lets_in(const storage_t *s, e_resource resource) {
+    return s->resource_state[resource] == STORAGE_STATE_PHARAOH_ACCEPT
+           || s->resource_state[resource] == STORAGE_STATE_PHARAOH_GET;
+}
+
+void building_storage_index_t::rebuild() {
+    OZZY_PROFILER_SECTION("Game/Run/Storage Index/Rebuild");
+    networks.clear();
+    yards.clear();
+    granaries.clear();
+
+    for (auto &b : city_buildings()) {
+        // mothballed storages stay indexed, callers skip them until they are valid again
+        if (b.type == BUILDING_NONE || (b.state != BUILDING_STATE_VALID && b.state != BUILDING_STATE_MOTHBALLED)) {
+            continue;
+        }
+
+        if (auto room = b.dcast_storage_room()) {
+            building_storage_yard *yard = room->yard();
+            if (!yard) {
+                continue;
+            }
+
+            auto &net = networks[room->road_network()];
+            const storage_t *s = yard->storage();
+            for (e_resource r = RESOURCE_MIN; r < RESOURCES_MAX; ++r) {
+                if (storage_lets_in(s, r)) {
+                    net.rooms[r].push_back(b.id);
+                }
+            }
+        } else if (b.dcast_storage_yard()) {
+            yards.push_back(b.id);
+        } else if (auto granary = b.dcast_granary()) {
+            granaries.push_back(b.id);
+
+            auto &net = networks[granary->road_network()];
+            net.all_granaries.push_back(b.id);
+            const storage_t *s = granary->storage();
+            for (e_resource r = RESOURCE_MIN; r < RESOURCES_MAX; ++r) {
+                if (storage_lets_in(s, r)) {
+                    net.granaries[r].push_back(b.id);
+                }
+            }
+        }
+    }
+
+    dirty = false;
+}
+
+const building_storage_index_t::network_t *building_storage_index_t::network(int road_network_id) {
+    if (dirty) {
+        rebuild();
+    }
+
+    auto it = networks.find(road_network_id);
+    return (it != networks.end()) ? &it->second : nullptr;
+}
+
+const building_storage_index_t::ids &building_storage_index_t::rooms_accepting(int road_network_id, e_resource resource) {
+    static const ids empty;
+    const network_t *net = network(road_network_id);
+    return net ? net->rooms[resource] : empty;
+}
+
+const building_storage_index_t::ids &building_storage_index_t::granaries_accepting(int road_network_id, e_resource resource) {
+    static const ids empty;
+    const network_t *net = network(road_network_id);
+    return net ? net->granaries[resource] : empty;
+}
+
+const building_storage_index_t::ids &building_storage_index_t::granaries_on_network(int road_network_id) {
+    static const ids empty;
+    const network_t *net = network(road_network_id);
+    return net ? net->all_granaries : empty;
+}
+
+const building_storage_index_t::ids &building_storage_index_t::all_yards() {
+    if (dirty) {
+        rebuild();
+    }
+    return yards;
+}
+
+const building_storage_index_t::ids &building_storage_index_t::all_granaries() {
+    if (dirty) {
+        rebuild();
+    }
+    return granaries;
+}
+
 const storage_t *building_storage::storage() const {
     return building_storage_get(base.storage_id);
 }
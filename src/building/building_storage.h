@@ -3,6 +3,9 @@
 #include "building/building.h"
 #include "game/resource.h"
 
+#include <unordered_map>
+#include <vector>
+
 constexpr int UNITS_PER_LOAD = 100;
 
 enum e_building_storage {
@@ -73,6 +76,37 @@ void building_storage_reset_building_ids(void);
 void building_storage_accept_none(int storage_id);
 void building_storage_toggle_empty_all(int storage_id);
 
+// storage buildings bucketed by road network and by the resources their orders let in,
+// so cart destination lookups only visit candidates instead of every building.
+// stock levels still change per tick and are checked by the callers
+struct building_storage_index_t {
+    using ids = std::vector<building_id>;
+
+    struct network_t {
+        ids rooms[RESOURCES_MAX];     // storage yard rooms whose yard accepts or gets the resource
+        ids granaries[RESOURCES_MAX]; // granaries that accept or get the resource
+        ids all_granaries;
+    };
+
+    std::unordered_map<int, network_t> networks;
+    ids yards;
+    ids granaries;
+    bool dirty = true;
+
+    inline void invalidate() { dirty = true; }
+
+    const ids &rooms_accepting(int road_network_id, e_resource resource);
+    const ids &granaries_accepting(int road_network_id, e_resource resource);
+    const ids &granaries_on_network(int road_network_id);
+    const ids &all_yards();
+    const ids &all_granaries();
+
+    void rebuild();
+    const network_t *network(int road_network_id);
+};
+
+extern building_storage_index_t g_storage_index;
+
 class building_storage : public building_impl {
 public:
     building_storage(building &b) : building_impl(b) {}
@@ -290,7 +290,7 @@ bool building_storage_yard::is_not_accepting(e_resource resource) {
 bool building_storage_yard::draw_ornaments_and_animations_height(painter &ctx, vec2i point, tile2i tile, color color_mask) {
     draw_normal_anim(ctx, point, tile, color_mask);
 
-    const auto &cover = anim("cover");
+    const auto &cover = anim(XSTR("cover"));
     ImageDraw::img_generic(ctx, cover.first_img(), point + cover.pos , color_mask);
 
     return true;
@@ -299,7 +299,7 @@ bool building_storage_yard::draw_ornaments_and_animations_height(painter &ctx, v
 int building_storage_yard_for_storing(tile2i tile, e_resource resource, int distance_from_entry, int road_network_id, int* understaffed, tile2i &dst) {
     int min_dist = 10000;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (building_id i : g_storage_index.rooms_accepting(road_network_id, resource)) {
         building_storage_room* room = building_get(i)->dcast_storage_room();
         if (!room || !room->is_valid()) {
             continue;
@@ -346,7 +346,7 @@ int building_storage_yard_for_storing(tile2i tile, e_resource resource, int dist
 int building_storage_yard::for_getting(e_resource resource, tile2i* dst) {
     int min_dist = 10000;
     building* min_building = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (building_id i : g_storage_index.all_yards()) {
         building_storage_yard *other_warehouse = building_get(i)->dcast_storage_yard();
         if (!other_warehouse || !other_warehouse->is_valid()) {
             continue;
@@ -61,7 +61,7 @@ void building_temple::spawn_figure() {
 }
 
 bool building_temple::draw_ornaments_and_animations_height(painter &ctx, vec2i point, tile2i tile, color color_mask) {
-    building_draw_normal_anim(ctx, point, &base, tile, anim("work"), color_mask);
+    building_draw_normal_anim(ctx, point, &base, tile, anim(XSTR("work")), color_mask);
 
     return true;
 }
@@ -301,7 +301,7 @@ bool building_mastaba::draw_ornaments_and_animations_flat_impl(building &base, p
         return false;
     }
 
-    int clear_land_id = anim("empty_land").first_img();
+    int clear_land_id = anim(XSTR("empty_land")).first_img();
     int image_grounded = small_mastaba_m.anim[animkeys().base].first_img() + 5;
     building *main = base.main();
     color_mask = (color_mask ? color_mask : 0xffffffff);
@@ -15,6 +15,7 @@
 #include "grid/figure.h"
 #include "grid/building_tiles.h"
 #include "grid/terrain.h"
+#include "grid/routing/routing_terrain.h"
 #include "core/calc.h"
 #include "core/log.h"
 #include "city/city.h"
@@ -36,7 +37,7 @@
 #define NOTHING 0
 #define INFINITE 10000
 
-grid_xx g_monuments_progress_grid = {0, FS_UINT32};
+grid_t<uint32_t> g_monuments_progress_grid;
 
 io_buffer* iob_monuments_progress_grid = new io_buffer([](io_buffer* iob, size_t version) {
     iob->bind(BIND_SIGNATURE_GRID, &g_monuments_progress_grid);
@@ -422,6 +423,9 @@ void building_monument_set_phase(building *b, int phase) {
     }
 
     monumentd.phase = phase;
+    // passable construction tiles depend on the phase, not on the terrain
+    map_routing_mark_land_dirty(b->tile.grid_offset());
+    map_routing_mark_land_dirty(b->tile.shifted(b->size - 1, b->size - 1).grid_offset());
     if (phase >= 2) {
         map_building_tiles_add(b->id, b->tile, b->size, building_image_get(b), TERRAIN_BUILDING);
     }
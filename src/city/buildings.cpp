@@ -7,10 +7,34 @@
 #include "grid/building.h"
 #include "grid/routing/routing.h"
 #include "city/city.h"
+#include "city/city_buildings.h"
+#include "dev/debug.h"
+#include "js/js_game.h"
 
 #include <set>
 
 static auto &city_data = g_city;
+
+enum e_building_dispatch_mode {
+    BUILDING_DISPATCH_SLOTS, // every slot in id order, hooks through the impl
+    BUILDING_DISPATCH_TYPES, // live buildings type by type, default hooks run inline
+};
+static e_building_dispatch_mode g_building_dispatch = BUILDING_DISPATCH_TYPES;
+
+declare_console_command_p(buildtick) {
+    std::string args; is >> args;
+
+    if (args == "slots") {
+        g_building_dispatch = BUILDING_DISPATCH_SLOTS;
+    } else if (args == "types") {
+        g_city.buildings.reset_live_buildings();
+        g_building_dispatch = BUILDING_DISPATCH_TYPES;
+    }
+
+    pcstr names[] = {"slots", "types"};
+    os << "building update dispatch: " << names[g_building_dispatch] << std::endl;
+}
+
 const auto palace_types = { BUILDING_VILLAGE_PALACE, BUILDING_TOWN_PALACE, BUILDING_VILLAGE_PALACE_UP, BUILDING_TOWN_PALACE_UP, BUILDING_CITY_PALACE };
 int city_buildings_t::get_palace_id() {
     for (auto btype : palace_types) {
@@ -36,6 +60,77 @@ void city_buildings_t::track_building(building &b, bool active) {
     g_city.buildings.increase_count(b.type, active);
 }
 
+void city_buildings_t::add_live_building(building &b) {
+    auto &live = *live_buildings;
+    if (!b.id || live.listed[b.id] == b.type) {
+        return;
+    }
+
+    remove_live_building(b.id);
+    if (b.type == BUILDING_NONE) {
+        return;
+    }
+
+    auto &ids = live.ids[b.type];
+    ids.insert(std::upper_bound(ids.begin(), ids.end(), b.id), b.id);
+    live.listed[b.id] = b.type;
+}
+
+void city_buildings_t::remove_live_building(building_id id) {
+    auto &live = *live_buildings;
+    const uint16_t type = live.listed[id];
+    if (type == BUILDING_NONE) {
+        return;
+    }
+
+    auto &ids = live.ids[type];
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it != ids.end() && *it == id) {
+        ids.erase(it);
+    }
+    live.listed[id] = BUILDING_NONE;
+}
+
+void city_buildings_t::reset_live_buildings() {
+    auto &live = *live_buildings;
+    for (auto &ids : live.ids) {
+        ids.clear();
+    }
+    live.listed.fill(BUILDING_NONE);
+
+    for (auto &b : city_buildings()) {
+        add_live_building(b);
+    }
+}
+
+// walks the live lists type by type, func(b, hooks) runs for the valid ones. a slot that changed type
+// moves to its new list, when that list was already walked in this pass the slot is handled right away
+template<typename F>
+static void live_buildings_do(city_buildings_t &city, F func) {
+    auto &live = *city.live_buildings;
+    for (int type = BUILDING_NONE + 1; type < BUILDING_MAX; ++type) {
+        const auto &hooks = building_impl::params((e_building_type)type).hooks;
+        auto &ids = live.ids[type];
+        for (size_t i = 0; i < ids.size();) {
+            building &b = *building_get(ids[i]);
+            if (b.type != type) {
+                city.add_live_building(b);
+                if (b.type != BUILDING_NONE && b.type < type && b.is_valid()) {
+                    func(b, building_impl::params(b.type).hooks);
+                }
+                continue;
+            }
+
+            if (b.is_valid()) {
+                func(b, hooks);
+            }
+
+            // hooks may create buildings, carry on after this id whatever got inserted
+            i = std::upper_bound(ids.begin(), ids.end(), b.id) - ids.begin();
+        }
+    }
+}
+
 void city_buildings_t::check_buildings_twins() {
 
 
@@ -237,23 +332,43 @@ void city_buildings_t::on_post_load () {
     });
 
     check_buildings_twins();
+    reset_live_buildings();
 }
 
 void city_buildings_t::init() {
     tracked_buildings = new tracked_buildings_t();
+    live_buildings = new live_buildings_t();
+    live_buildings->listed.fill(BUILDING_NONE);
 }
 
 void city_buildings_t::shutdown() {
     delete tracked_buildings;
     tracked_buildings = nullptr;
+    delete live_buildings;
+    live_buildings = nullptr;
 }
 
 void city_buildings_t::update_tick(bool refresh_only) {
-    for (auto it = building_begin(), end = building_end(); it != end; ++it) {
-        if (it->is_valid()) {
-            it->dcast()->on_tick(refresh_only);
+    if (g_building_dispatch == BUILDING_DISPATCH_SLOTS) {
+        for (auto it = building_begin(), end = building_end(); it != end; ++it) {
+            if (it->is_valid()) {
+                it->dcast()->on_tick(refresh_only);
+            }
         }
+        return;
     }
+
+    live_buildings_do(*this, [refresh_only] (building &b, const auto &hooks) {
+        if (hooks.on_tick) {
+            b.dcast()->on_tick(refresh_only);
+            return;
+        }
+
+        // building_impl::on_tick(), no need to acquire the impl for it
+        if (b.anim.valid()) {
+            b.anim.update(refresh_only);
+        }
+    });
 }
 
 void city_buildings_t::reset_tracked_buildings_counters() {
@@ -263,14 +378,38 @@ void city_buildings_t::reset_tracked_buildings_counters() {
 }
 
 void city_buildings_t::update_day() {
-    buildings_valid_do([] (building &b) {
-        b.dcast()->update_day();
+    if (g_building_dispatch == BUILDING_DISPATCH_SLOTS) {
+        buildings_valid_do([] (building &b) {
+            b.dcast()->update_day();
+        });
+        return;
+    }
+
+    live_buildings_do(*this, [] (building &b, const auto &hooks) {
+        if (hooks.update_day) {
+            b.dcast()->update_day();
+            return;
+        }
+
+        // building_impl::update_day() -> update_graphic()
+        b.minimap_anim = building_impl::params(b.type).anim[XSTR("minimap")];
     });
 }
 
 void city_buildings_t::reload_objects() {
-    buildings_valid_do([] (building &b) {
-        b.dcast()->on_config_reload();
+    // after a partial refresh only the types whose section was read again
+    const auto &scope = config::refresh_scope();
+    std::array<int8_t, BUILDING_MAX> affected;
+    affected.fill(-1);
+    buildings_valid_do([&] (building &b) {
+        int8_t &reload = affected[b.type];
+        if (reload < 0) {
+            reload = scope.affects(building_impl::params(b.type).name) ? 1 : 0;
+        }
+
+        if (reload) {
+            b.dcast()->on_config_reload();
+        }
     });
 }
 
@@ -304,8 +443,17 @@ span_const<e_building_type> city_buildings_t::temple_complex_types() {
 }
 
 void city_buildings_t::update_month() {
-    buildings_valid_do([] (building &b) {
-        b.dcast()->update_month();
+    if (g_building_dispatch == BUILDING_DISPATCH_SLOTS) {
+        buildings_valid_do([] (building &b) {
+            b.dcast()->update_month();
+        });
+        return;
+    }
+
+    live_buildings_do(*this, [] (building &b, const auto &hooks) {
+        if (hooks.update_month) {
+            b.dcast()->update_month();
+        }
     });
 }
 
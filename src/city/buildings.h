@@ -37,6 +37,14 @@ struct city_buildings_t {
     using tracked_buildings_t = std::array<tracked_building_ids, BUILDING_MAX>;
     tracked_buildings_t *tracked_buildings = nullptr;
 
+    // every slot with a type, bucketed by that type in id order. kept on create/destroy,
+    // slots whose type changed since are moved over when the periodic updates walk the lists
+    struct live_buildings_t {
+        tracked_buildings_t ids;
+        std::array<uint16_t, MAX_BUILDINGS> listed; // type the slot is listed under
+    };
+    live_buildings_t *live_buildings = nullptr;
+
     int32_t mission_post_operational;
     tile2i main_native_meeting;
     int8_t unknown_value;
@@ -69,6 +77,9 @@ struct city_buildings_t {
 
     void reset_tracked_buildings_counters();
     void track_building(building &b, bool active);
+    void add_live_building(building &b);
+    void remove_live_building(building_id id);
+    void reset_live_buildings();
     const tracked_building_ids &track_buildings(e_building_type type) const { return tracked_buildings->at(type); }
 
     void clear_fishing_boat_requests() { fishing_boats_requested = 0; }
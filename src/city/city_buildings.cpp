@@ -3,6 +3,7 @@
 #include "game/undo.h"
 #include "core/custom_span.hpp"
 #include "core/profiler.h"
+#include "core/random.h"
 #include "city/city_warnings.h"
 #include "city/city.h"
 #include "game/game_events.h"
@@ -13,6 +14,7 @@
 #include "grid/building_tiles.h"
 #include "grid/routing/routing_terrain.h"
 #include "building/building_house.h"
+#include "building/building_storage.h"
 #include "building/building_wall.h"
 #include "io/io_buffer.h"
 
@@ -59,7 +61,7 @@ building_id building_id_random(e_building_type type) {
     }
 
     if (bs.size() > 0) {
-        const int randv = std::rand() % bs.size();
+        const int randv = random_sim_between(0, bs.size());
         return bs[randv];
     }
 
@@ -94,6 +96,7 @@ building *building_create(e_building_type type, tile2i tile, int orientation) {
 
     memset(b->runtime_data, 0, sizeof(b->runtime_data));
     b->new_fill_in_data_for_type(type, tile, orientation);
+    g_city.buildings.add_live_building(*b);
 
     events::emit(event_building_create{ b->id });
 
@@ -144,6 +147,10 @@ void building_clear_all() {
         memset(&g_all_buildings[i], 0, sizeof(building));
         g_all_buildings[i].id = i;
     }
+
+    if (g_city.buildings.live_buildings) {
+        g_city.buildings.reset_live_buildings();
+    }
 }
 
 static void building_delete_UNSAFE(building *b) {
@@ -151,6 +158,7 @@ static void building_delete_UNSAFE(building *b) {
     int id = b->id;
     memset(b, 0, sizeof(building));
     b->id = id;
+    g_city.buildings.remove_live_building(id);
 }
 
 void building_update_state(void) {
@@ -163,11 +171,19 @@ void building_update_state(void) {
 
     for (int i = 1; i < MAX_BUILDINGS; i++) {
         building *b = &g_all_buildings[i];
+        const bool is_storage = building_type_any_of(*b, BUILDING_GRANARY, BUILDING_STORAGE_YARD, BUILDING_STORAGE_ROOM);
         if (b->state == BUILDING_STATE_CREATED) {
             b->state = BUILDING_STATE_VALID;
+            if (is_storage) {
+                g_storage_index.invalidate();
+            }
         }
 
         if (b->state != BUILDING_STATE_VALID) {
+            if (is_storage && b->state != BUILDING_STATE_UNUSED && b->state != BUILDING_STATE_MOTHBALLED) {
+                g_storage_index.invalidate();
+            }
+
             if (b->state == BUILDING_STATE_UNDO || b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
                 const auto &params = b->dcast()->params();
                 canals_recalc |= params.updates.canals;
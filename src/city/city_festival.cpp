@@ -10,6 +10,7 @@
 #include "city/city_message.h"
 #include "core/random.h"
 #include "figure/figure.h"
+#include "grid/figure_index.h"
 #include "game/game_config.h"
 #include "graphics/image_groups.h"
 
@@ -101,12 +102,13 @@ void city_festival_t::execute_festival() {
                                       //                        b->remove_figure(0);
                 figure* f = b->create_figure_generic(FIGURE_FESTIVAL_PRIEST, FIGURE_ACTION_10_FESTIVAL_PRIEST_CREATED, BUILDING_SLOT_PRIEST, DIR_4_BOTTOM_LEFT);
                 
-                tile2i tile_on_square = square_pos.shifted(rand() % square->size, rand() % square->size);
+                tile2i tile_on_square = square_pos.shifted(random_sim_between(0, square->size), random_sim_between(0, square->size));
                 f->tile = b->road_access;
+                map_figure_index_update(*f);
                 f->set_destination(square);
                 f->destination_tile = tile_on_square;
-                f->festival_remaining_dances = rand() % 10;
-                f->wait_ticks = rand() % 10;
+                f->festival_remaining_dances = random_sim_between(0, 10);
+                f->wait_ticks = random_sim_between(0, 10);
             }
             break;
         }
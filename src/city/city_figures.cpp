@@ -6,6 +6,10 @@
 #include "figure/figure_names.h"
 #include "core/custom_span.hpp"
 #include "core/random.h"
+#include "grid/figure_index.h"
+#include "js/js_game.h"
+
+#include <array>
 
 struct figure_data_t {
     //int created_sequence;
@@ -45,12 +49,23 @@ void city_figures_t::init_figures() {
 }
 
 void city_figures_t::reload_objects() {
+    // after a partial refresh only the types whose section was read again
+    const auto &scope = config::refresh_scope();
+    std::array<int8_t, FIGURE_MAX> affected;
+    affected.fill(-1);
     for (auto &figure : map_figures()) {
         if (!figure || figure->type == FIGURE_NONE) {
             continue;
         }
 
-        figure->dcast()->on_config_reload();
+        int8_t &reload = affected[figure->type];
+        if (reload < 0) {
+            reload = scope.affects(figure_impl::params(figure->type).name) ? 1 : 0;
+        }
+
+        if (reload) {
+            figure->dcast()->on_config_reload();
+        }
     }
 }
 
@@ -62,6 +77,10 @@ void city_figures_t::on_post_load() {
 
         figure->dcast()->on_post_load();
     }
+
+    count_fighting();
+    map_figure_index_clear();
+    map_figure_index_sync();
 }
 
 void city_figures_t::update() {
@@ -69,11 +88,27 @@ void city_figures_t::update() {
     reset();
     //g_city.entertainment.hippodrome_has_race = false;
 
+    // picks up figures whose tile was set without going through map_figure_add()
+    map_figure_index_sync();
+    count_fighting();
+
+    // actions share the random sequence, routing grids, tile figure chains and buildings,
+    // a figure sees what the figures before it did this tick. keep them in slot order
     for (auto &figure: map_figures()) {
         figure->action_perform();
     }
 }
 
+void city_figures_t::count_fighting() {
+    // fights that start during the tick are added by figure_combat_attack_figure_at()
+    fighting = 0;
+    for (auto *f : map_figures()) {
+        if (f->is_valid() && f->action_state == FIGURE_ACTION_150_ATTACK) {
+            fighting++;
+        }
+    }
+}
+
 void city_figures_t::add_animal() {
     animals_number++;
 }
@@ -172,6 +207,7 @@ void figure_clear_all() {
         f->state = FIGURE_STATE_NONE;
         f->id = figure_id;
     }
+    map_figure_index_clear();
 }
 
 io_buffer *iob_figures = new io_buffer([] (io_buffer *iob, size_t version) {
@@ -9,6 +9,7 @@ struct city_figures_t {
     uint8_t animals_number;
     int32_t attacking_natives;
     int32_t enemies;
+    int32_t fighting; // figures in FIGURE_ACTION_150_ATTACK, routing avoids their tiles
     int32_t kingdome_soldiers;
     int32_t rioters;
     int32_t soldiers;
@@ -18,6 +19,7 @@ struct city_figures_t {
     void on_post_load();
     void update();
     void add_animal();
+    void count_fighting();
     void init_figures();
     void reload_objects();
 };
@@ -6,10 +6,9 @@
 #include "city/city_figures.h"
 #include "grid/water.h"
 #include "grid/figure.h"
+#include "core/random.h"
 
 #include <algorithm>
-#include <random>
-#include <time.h>
 
 void city_fishing_points_t::create() {
     scenario_map_foreach_fishing_point([] (tile2i tile) {
@@ -27,10 +26,7 @@ tile2i city_fishing_points_t::random_fishing_point(tile2i pos, bool free_only) {
         return tile2i::invalid;
     }
 
-    std::random_device rd;
-    std::mt19937 g(rd());
-
-    std::shuffle(std::begin(apoints), std::end(apoints), g);
+    std::shuffle(std::begin(apoints), std::end(apoints), random_sim_engine{});
     for (auto p: apoints) {
         if (free_only) {
             grid_area area = map_grid_get_area(p, 1, 1);
@@ -126,10 +122,8 @@ void city_fishing_points_t::update(int points_num) {
         }
     }
 
-    srand (time(nullptr));
-
     for (int i = 0; i < num_fishing_spots; i++) {
-        int index = rand() % deep_water.size();
+        int index = random_sim_between(0, deep_water.size());
         g_scenario.fishing_points[i] = tile2i(deep_water[index]);
     }
 
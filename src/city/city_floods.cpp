@@ -210,7 +210,7 @@ void floods_t::update_next_flood_params() {
 
     quality_current = quality_next;
     // calculate the next flood quality
-    int quality_randm = (rand() % 100) + 20;
+    int quality_randm = random_sim_between(0, 100) + 20;
     quality_next += quality_randm;
     quality_next = quality_next % 100;
 }
@@ -1,6 +1,7 @@
 #include "city_maintenance.h"
 
 #include "building/building_house.h"
+#include "building/building_storage.h"
 #include "building/building_temple_complex.h"
 #include "grid/random.h"
 #include "grid/road_access.h"
@@ -214,6 +215,9 @@ void city_maintenance_t::check_kingdome_access() {
         }
     });
 
+    // road networks may have been renumbered
+    g_storage_index.invalidate();
+
     {
         //OZZY_PROFILER_SECTION("Game/Run/Tick/Check Rome Access/Exit Check");
         //map_point& exit_point = city_map_exit_point();
@@ -552,7 +552,7 @@ void city_religion_t::perform_major_blessing(e_god god) {
     case GOD_OSIRIS:
         if (anti_scum_random_bool()) {
             // double farm yields
-            osiris_double_farm_yield_days = 100 + rand() % 50;
+            osiris_double_farm_yield_days = 100 + random_sim_between(0, 50);
             messages::god(GOD_OSIRIS, MESSAGE_BLESSING_OSIRIS_FARMS );
             return;
         } else {
@@ -6,6 +6,8 @@
 #include "core/log.h"
 #include "core/custom_span.hpp"
 #include "core/profiler.h"
+#include "core/system_time.h"
+#include "core/threading.h"
 #include "graphics/font.h"
 #include "io/io.h"
 #include "platform/renderer.h"
@@ -13,6 +15,7 @@
 #include "graphics/text.h"
 #include "graphics/screen.h"
 #include "graphics/image.h"
+#include "graphics/sprite_batch.h"
 
 #include "game/game.h"
 
@@ -26,6 +29,27 @@
 SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src);
 image_packer packer;
 
+// read-only cursor over bitmap data, every decode job owns its own copy
+// so images from the same .555 can be converted concurrently
+struct pak_reader {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    size_t index = 0;
+
+    inline uint8_t read_u8() {
+        return (index < size) ? data[index++] : 0;
+    }
+
+    inline uint16_t read_u16() {
+        if (index + 2 > size) {
+            return 0;
+        }
+        uint16_t result = (uint16_t)(data[index] | (data[index + 1] << 8));
+        index += 2;
+        return result;
+    }
+};
+
 static color to_32_bit(uint16_t c) {
     return ALPHA_OPAQUE | ((c & 0x7c00) << 9) | ((c & 0x7000) << 4) | ((c & 0x3e0) << 6) | ((c & 0x380) << 1) | ((c & 0x1f) << 3) | ((c & 0x1c) >> 2);
 }
@@ -50,7 +74,7 @@ static int copy_to_atlas(const image_t* img) {
     return pixels_count;
 }
 
-static int convert_uncompressed(buffer* buf, const image_t &img) {
+static int convert_uncompressed(pak_reader* buf, const image_t &img) {
     int pixels_count = 0;
     atlas_data_t *p_atlas = img.atlas.p_atlas;
 
@@ -65,7 +89,7 @@ static int convert_uncompressed(buffer* buf, const image_t &img) {
     return pixels_count;
 }
 
-static int convert_compressed(buffer* buf, int data_length, const image_t &img) {
+static int convert_compressed(pak_reader* buf, int data_length, const image_t &img) {
     // int pixels_count = 0;
     atlas_data_t *p_atlas = img.atlas.p_atlas;
     int atlas_dst = (img.atlas.offset.y * p_atlas->width) + img.atlas.offset.x;
@@ -105,7 +129,7 @@ static const int FOOTPRINT_X_START_PER_HEIGHT[] = {
 constexpr int FOOTPRINT_HEIGHT = 30;
 #define FOOTPRINT_HALF_HEIGHT 15
 
-static int convert_footprint_tile(buffer* buf, const image_t &img, int x_offset, int y_offset) {
+static int convert_footprint_tile(pak_reader* buf, const image_t &img, int x_offset, int y_offset) {
     int pixels_count = 0;
     auto p_atlas = img.atlas.p_atlas;
 
@@ -122,7 +146,7 @@ static int convert_footprint_tile(buffer* buf, const image_t &img, int x_offset,
     return pixels_count;
 }
 
-static int convert_isometric_footprint(buffer* buf, const image_t &img) {
+static int convert_isometric_footprint(pak_reader* buf, const image_t &img) {
     int pixels_count = 0;
     auto p_atlas = img.atlas.p_atlas;
 
@@ -221,7 +245,7 @@ static void add_edge_to_letter(const image_t &img) {
     delete [] TEMP_BUFFER;
 }
 
-static int convert_font_glyph_to_bigger_space(buffer* buf, const image_t* img) {
+static int convert_font_glyph_to_bigger_space(pak_reader* buf, const image_t* img) {
     int pixels_count = 0;
     auto p_atlas = img->atlas.p_atlas;
 
@@ -255,8 +279,8 @@ static bool is_font_glyph_in_range(const image_t &img, e_font font_start, e_font
     return false;
 }
 
-static buffer* external_image_buf = nullptr;
-static buffer* load_external_data(const image_t &img) {
+static thread_local buffer* external_image_buf = nullptr;
+static bool load_external_data(const image_t &img, pak_reader &reader) {
     int size = 0;
     safe_realloc_for_size(&external_image_buf, img.data_length);
 
@@ -271,10 +295,12 @@ static buffer* load_external_data(const image_t &img) {
         size = io_read_file_part_into_buffer(filename, MAY_BE_LOCALIZED, external_image_buf, img.data_length, img.sgx_data_offset - 1);
         if (!size) {
             logs::error("unable to load external image %s", img.bmp.name.c_str());
-            return nullptr;
+            return false;
         }
     }
-    return external_image_buf;
+
+    reader = {external_image_buf->get_data(), (size_t)size, 0};
+    return true;
 }
 
 static int isometric_calculate_top_height(const image_t &img) {
@@ -321,13 +347,12 @@ static void isometric_clear_foot_bottom(const image_t &img) {
     }
 }
 
-static bool convert_image_data(buffer* buf, image_t &img, bool convert_fonts) {
-    if (img.is_external)
-        buf = load_external_data(img);
-
-    if (buf == nullptr)
+static bool convert_image_data(pak_reader reader, image_t &img, bool convert_fonts) {
+    if (img.is_external && !load_external_data(img, reader))
         return false;
 
+    pak_reader *buf = &reader;
+
     img.temp_pixel_data = &img.atlas.p_atlas->temp_pixel_buffer[(img.atlas.offset.y * img.atlas.p_atlas->width) + img.atlas.offset.x];
 
     if (img.type == IMAGE_TYPE_ISOMETRIC) {
@@ -404,6 +429,8 @@ span_const<uint16_t> imagepak::image_ids() {
 }
 
 void imagepak::cleanup_and_destroy() {
+    // queued sprites may still reference these atlas pages
+    g_sprite_batch.flush();
     for (int i = 0; i < atlas_pages.size(); ++i) {
         auto atlas_data = atlas_pages.at(i);
         if (atlas_data.temp_pixel_buffer != nullptr)
@@ -620,6 +647,9 @@ buffer* pak_buf = new buffer(MAX_FILE_SCRATCH_SIZE);
 bool imagepak::load_pak(pcstr pak_name, int starting_index) {
     OZZY_PROFILER_SECTION("Game/Loading/Resources/ImagePak");
 
+    timer stage_timer;
+    stage_timer.start();
+
     // construct proper filepaths
     name = pak_name;
     vfs::path filename_full("Data/", pak_name);
@@ -837,13 +867,16 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
 
     // *********** PAK_FILE.555 ************
 
-    // read bitmap data into buffer
-    safe_realloc_for_size(&pak_buf, MAX_FILE_SCRATCH_SIZE);
-    if (!io_read_file_into_buffer((const char *)filename_555, MAY_BE_LOCALIZED, pak_buf, MAX_FILE_SCRATCH_SIZE)) {
+    // bitmap data is decoded straight from the file mapping, no scratch copy
+    vfs::path fs_555 = vfs::content_file(filename_555);
+    vfs::reader pak_file = fs_555.empty() ? vfs::reader() : vfs::file_open(fs_555);
+    if (!pak_file || pak_file->size() <= 0) {
         return false;
     }
 
     // finish filling in image and atlas information
+    std::vector<image_t*> decode_list;
+    decode_list.reserve(images_array.size());
     for (auto &img: images_array) {
         if (has_system_bmp && !should_load_system_sprites && img.sgx_index < 201) {
             continue;
@@ -859,13 +892,36 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
         img.atlas.p_atlas = p_data;
         img.atlas.offset = rect->output.pos;
         //        p_data->images.push_back(img);
+        decode_list.push_back(&img);
+    }
+    load_stats.read_ms = stage_timer.get_elapsed_ms();
+
+    // load and convert image bitmap data, every image owns its packer rect
+    // in the atlas so the conversion can be spread over the worker pool
+    stage_timer.start();
+    {
+        OZZY_PROFILER_SECTION("Game/Loading/Resources/ImagePak/Decode");
+        const pak_reader pak_data{(const uint8_t *)pak_file->data(), (size_t)pak_file->size(), 0};
+        auto decode_block = [&] (int first, int last) {
+            for (int i = first; i < last; ++i) {
+                image_t &img = *decode_list[i];
+                pak_reader reader = pak_data;
+                reader.index = img.sgx_data_offset;
+                convert_image_data(reader, img, should_convert_fonts);
+            }
+        };
 
-        // load and convert image bitmap data
-        pak_buf->set_offset(img.sgx_data_offset);
-        convert_image_data(pak_buf, img, should_convert_fonts);
+        const int decode_count = (int)decode_list.size();
+        if (threading::this_thread::get_pool() == &game.mt) {
+            decode_block(0, decode_count);
+        } else {
+            game.mt.submit_blocks(0, decode_count, decode_block).wait();
+        }
     }
+    load_stats.decode_ms = stage_timer.get_elapsed_ms();
 
     // create textures from atlas data
+    stage_timer.start();
     for (int i = 0; i < atlas_pages.size(); ++i) {
         atlas_data_t* atlas_data = &atlas_pages.at(i);
         atlas_data->texture = graphics_renderer()->create_texture_from_buffer(atlas_data->temp_pixel_buffer, atlas_data->width, atlas_data->height);
@@ -887,6 +943,8 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
         // ******************************
     }
 
+    load_stats.upload_ms = stage_timer.get_elapsed_ms();
+
     // remove pointers to raw data buffer in the images
     for (int i = 0; i < images_array.size(); ++i) {
         auto img = images_array.at(i);
@@ -899,6 +957,8 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
                filename_sgx.c_str(),
                entries_num, groups_num,
                atlas_pages.at(atlas_pages.size() - 1).width, atlas_pages.at(atlas_pages.size() - 1).height, atlas_pages.size());
+    logs::info("Imagepak '%s' timings: read %u ms, decode %u ms, upload %u ms",
+               pak_name, load_stats.read_ms, load_stats.decode_ms, load_stats.upload_ms);
 
     int y_offset = screen_height() - 24;
 
@@ -34,8 +34,15 @@ class imagepak {
     void cleanup_and_destroy();
 
 public:
+    struct load_stats_t {
+        uint32_t read_ms = 0;
+        uint32_t decode_ms = 0;
+        uint32_t upload_ms = 0;
+    };
+
     bstring256 name;
     std::vector<atlas_data_t> atlas_pages;
+    load_stats_t load_stats;
 
     int global_image_index_offset = 0;
 
@@ -164,6 +164,23 @@ public:
     }
 };
 
+// reader over memory it does not own, e.g. resources compiled into the executable
+class view_reader : public data_reader {
+public:
+    inline view_reader(pcstr _debug_info, const void *data, int size) : data_reader(_debug_info, (void *)data, size) {}
+    virtual ~view_reader() { __data = nullptr; }
+};
+
+// reader over a read-only mapping of the whole file, the data must not be written
+class mapped_reader : public data_reader {
+public:
+    inline mapped_reader(pcstr _debug_info, void *data, int size, void *mapping) : data_reader(_debug_info, data, size), __mapping(mapping) {}
+    virtual ~mapped_reader();
+
+private:
+    void *__mapping;
+};
+
 using reader = std::shared_ptr<data_reader>;
 
 } // vfs
\ No newline at end of file
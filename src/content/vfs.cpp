@@ -11,6 +11,15 @@
 #include <sstream>
 #include <memory>
 
+#if defined(GAME_PLATFORM_WIN)
+#include <io.h>
+#include <windows.h>
+#elif defined(GAME_PLATFORM_UNIX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define GAME_VFS_MMAP
+#endif
+
 #if defined( __EMSCRIPTEN__ )
 #include <emscripten.h>
 EM_ASYNC_JS(void, __sync_em_fs, (), {
@@ -40,19 +49,84 @@ void log_io(pcstr fmt, Args ... args) {
     logs::info(fmt, args...);
 }
 
+#if defined(GAME_PLATFORM_WIN)
+
+mapped_reader::~mapped_reader() {
+    UnmapViewOfFile(__data);
+    CloseHandle((HANDLE)__mapping);
+    __data = nullptr;
+}
+
+static reader file_map(pcstr debug_info, FILE *f) {
+    HANDLE file = (HANDLE)_get_osfhandle(_fileno(f));
+    LARGE_INTEGER size;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size) || size.QuadPart <= 0 || size.QuadPart > INT32_MAX) {
+        return reader();
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        return reader();
+    }
+
+    void *mem = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!mem) {
+        CloseHandle(mapping);
+        return reader();
+    }
+
+    return std::make_shared<mapped_reader>(debug_info, mem, (int)size.QuadPart, (void *)mapping);
+}
+
+#elif defined(GAME_VFS_MMAP)
+
+mapped_reader::~mapped_reader() {
+    munmap((void *)__data, __size);
+    __data = nullptr;
+}
+
+static reader file_map(pcstr debug_info, FILE *f) {
+    struct stat st;
+    const int fd = fileno(f);
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > INT32_MAX) {
+        return reader();
+    }
+
+    void *mem = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem == MAP_FAILED) {
+        return reader();
+    }
+
+    return std::make_shared<mapped_reader>(debug_info, mem, (int)st.st_size, nullptr);
+}
+
+#else
+
+mapped_reader::~mapped_reader() {
+    __data = nullptr;
+}
+
+static reader file_map(pcstr debug_info, FILE *f) {
+    return reader();
+}
+
+#endif
+
 reader file_open(path path, pcstr mode) {
     log_io("[begn] file_open %s", path.c_str());
     const bool is_text_file = !!strstr(mode, "t");
     if (!path.empty() && path.data()[0] == ':') {
         auto data = internal_file_open(path.c_str());
+        if (data.first && !is_text_file) {
+            log_io("[intr] view of %s", path.c_str());
+            return std::make_shared<view_reader>(path.c_str(), data.first, data.second);
+        }
+
         if (data.first) {
             log_io("[intr] loaded from %s", path.c_str());
-            const int addb = is_text_file ? 1 : 0;
-            void *mem = malloc(data.second + is_text_file);
+            void *mem = malloc(data.second + 1);
             memcpy(mem, data.first, data.second);
-            if (is_text_file) {
-                ((char *)mem)[data.second] = 0; // null-terminate the string
-            }
+            ((char *)mem)[data.second] = 0; // null-terminate the string
             return std::make_shared<data_reader>(path.c_str(), mem, data.second);
         }
 
@@ -76,6 +150,15 @@ reader file_open(path path, pcstr mode) {
     }
 
     FILE *f = file_open_os(path.c_str(), mode);
+    if (f && !strchr(mode, 'w') && !strchr(mode, '+')) {
+        reader mapped = file_map(path.c_str(), f);
+        if (mapped) {
+            log_io("[mmap] file_open %s", path.c_str());
+            fclose(f);
+            return mapped;
+        }
+    }
+
     if (f) {
         log_io("[binr] file_open %s", path.c_str());
         fseek(f, 0, SEEK_END);
@@ -4,6 +4,7 @@
 #include "game/game_events.h"
 #include "platform/screen.h"
 #include "graphics/screenshot.h"
+#include "io/gamestate/boilerplate.h"
 #include "core/log.h"
 #include <SDL.h>
 
@@ -70,4 +71,8 @@ void application_t::subscribe_events() {
     events::subscribe_permanent([] (event_app_city_screenshot ev) {
         graphics_save_screenshot(SCREENSHOT_FULL_CITY);
     });
+
+    events::subscribe_permanent([] (event_savegame_written ev) {
+        GamestateIO::on_savegame_written(ev.ok);
+    });
 }
@@ -1,154 +1,226 @@
 #include "core/archive.h"
+#include "core/archive_snapshot.h"
 
 #include "graphics/animation.h"
 #include "graphics/image_desc.h"
 
 #include "mujs/mujs.h"
 
+#include <algorithm>
+#include <cmath>
+
 void archive::getproperty(int idx, pcstr name) {
-    js_getproperty((js_State*)state, idx, name);
+    getproperty(*this, idx, name);
 }
 
 void archive::getproperty(archive arch, int idx, pcstr name) {
+    if (auto snapshot = archive_snapshot::from(arch.state)) {
+        return snapshot->getproperty(idx, name);
+    }
     js_getproperty((js_State *)(arch.state), idx, name);
 }
 
 bool archive::isarray(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->isarray(idx);
+    }
     return js_isarray((js_State*)state, idx);
 }
 
 int archive::getlength(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->getlength(idx);
+    }
     return js_getlength((js_State*)state, idx);
 }
 
 void archive::getindex(int idx, int i) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->getindex(idx, i);
+    }
     js_getindex((js_State*)state, idx, i);
 }
 
+bool archive::isundefined(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->type(idx) == archive_snapshot::node_undefined;
+    }
+    return js_isundefined((js_State *)state, idx);
+}
+
 bool archive::isnumber(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->type(idx) == archive_snapshot::node_number;
+    }
     return (js_isnumber((js_State*)state, idx) || js_iscnumber((js_State*)state, idx));
 }
 
 bool archive::isstring(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->type(idx) == archive_snapshot::node_string;
+    }
     return js_isstring((js_State *)state, idx);
 }
 
 bool archive::isboolean(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->type(idx) == archive_snapshot::node_bool;
+    }
     return js_isboolean((js_State *)state, idx);
 }
 
 double archive::tonumber(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->tonumber(idx);
+    }
     return js_tonumber((js_State*)state, idx);
 }
 
+int archive::tointeger(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        const double n = snapshot->tonumber(idx);
+        if (std::isnan(n)) return 0;
+        if (n == 0 || std::isinf(n)) return (int)n;
+        return (int)(n < 0 ? -std::floor(-n) : std::floor(n));
+    }
+    return js_tointeger((js_State *)state, idx);
+}
+
+uint32_t archive::touint32(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        double n = snapshot->tonumber(idx);
+        if (!std::isfinite(n) || n == 0) return 0;
+        n = std::fmod(n, 4294967296.0);
+        n = n >= 0 ? std::floor(n) : std::ceil(n) + 4294967296.0;
+        return (uint32_t)n;
+    }
+    return js_touint32((js_State *)state, idx);
+}
+
 pcstr archive::tostring(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->tostring(idx);
+    }
     return js_tostring((js_State *)state, idx);
 }
 
 bool archive::toboolean(int idx) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->toboolean(idx);
+    }
     return js_toboolean((js_State *)state, idx);
 }
 
 void archive::pop(int num) {
-    js_pop((js_State *)state, num);
+    pop(*this, num);
 }
 
 void archive::pop(archive arch, int n) {
+    if (auto snapshot = archive_snapshot::from(arch.state)) {
+        return snapshot->pop(n);
+    }
     js_pop((js_State *)(arch.state), n);
 }
 
 bool archive::isobject(int idx) {
-    return js_isobject((js_State *)state, idx);
+    return isobject(*this, idx);
 }
 
 bool archive::isobject(archive arch, int idx) {
+    if (auto snapshot = archive_snapshot::from(arch.state)) {
+        return snapshot->isobject(idx);
+    }
     return js_isobject((js_State *)(arch.state), idx);
 }
 
 void archive::pushiterator(archive arch, int idx, int own) {
+    if (auto snapshot = archive_snapshot::from(arch.state)) {
+        return snapshot->pushiterator(idx);
+    }
     js_pushiterator((js_State *)(arch.state), idx, own);
 }
 
 pcstr archive::nextiterator(archive arch, int idx) {
+    if (auto snapshot = archive_snapshot::from(arch.state)) {
+        return snapshot->nextiterator(idx);
+    }
     return js_nextiterator((js_State *)(arch.state), idx);
 }
 
 void archive::getglobal(pcstr name) {
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->getglobal(name);
+    }
     js_getglobal((js_State *)state, name);
 }
 
 const uint8_t *lang_get_string(int group, int index);
 pcstr archive::r_string(pcstr name) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     pcstr result = "";
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         ;
-    } else if (js_isstring(vm, -1)) {
-        result = js_tostring(vm, -1);
-    } else if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
+    } else if (isstring(-1)) {
+        result = tostring(-1);
+    } else if (isarray(-1)) {
+        int length = getlength(-1);
         vec2i gx;
         if (length == 2) {
-            js_getindex(vm, -1, 0); gx.x = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
-            js_getindex(vm, -1, 1); gx.y = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+            getindex(-1, 0); gx.x = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
+            getindex(-1, 1); gx.y = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
         }
 
         result = (pcstr)lang_get_string(gx.x, gx.y);
-    } else if (js_isobject(vm, -1)) {
-        js_getproperty(vm, -1, "group"); int group = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "id"); int id = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
+    } else if (isobject(-1)) {
+        getproperty(-1, "group"); int group = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "id"); int id = isundefined(-1) ? 0 : tointeger(-1); pop(1);
         result = (pcstr)lang_get_string(group, id);
     }
-    js_pop(vm, 1);
+    pop(1);
     return result;
 }
 
 std::vector<std::string> archive::r_array_str(pcstr name) {
-    auto vm = (js_State *)state;
-
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     std::vector<std::string> result;
-    if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
+    if (isarray(-1)) {
+        int length = getlength(-1);
         for (int i = 0; i < length; ++i) {
-            js_getindex(vm, -1, i);
-            pcstr v = js_tostring(vm, -1);
+            getindex(-1, i);
+            pcstr v = tostring(-1);
             result.emplace_back(v);
-            js_pop(vm, 1);
+            pop(1);
         }
     }
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         int i = 0;
         ;
     }
-    if (js_isobject(vm, -1)) {
+    if (isobject(-1)) {
         int i = 0;
         ;
     }
-    js_pop(vm, 1);
+    pop(1);
 
     return result;
 }
 
 std::vector<std::string> archive::to_array_str() {
-    auto vm = (js_State *)state;
-
     std::vector<std::string> result;
-    if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
+    if (isarray(-1)) {
+        int length = getlength(-1);
         for (int i = 0; i < length; ++i) {
-            js_getindex(vm, -1, i);
-            pcstr v = js_tostring(vm, -1);
+            getindex(-1, i);
+            pcstr v = tostring(-1);
             result.emplace_back(v);
-            js_pop(vm, 1);
+            pop(1);
         }
     }
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         int i = 0;
         ;
     }
-    if (js_isobject(vm, -1)) {
+    if (isobject(-1)) {
         int i = 0;
         ;
     }
@@ -157,24 +229,22 @@ std::vector<std::string> archive::to_array_str() {
 }
 
 archive::variant_t archive::to_variant() {
-    auto vm = (js_State *)state;
-
     variant_t result;
     pcstr name = "unknown";
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         result = variant_t(variant_none_t{ name });
-    } else if (js_isstring(vm, -1)) {
-        const xstring str = js_tostring(vm, -1);
+    } else if (isstring(-1)) {
+        const xstring str = tostring(-1);
         result = variant_t(str);
-    } else if (js_isboolean(vm, -1)) {
-        const bool v = js_toboolean(vm, -1);
+    } else if (isboolean(-1)) {
+        const bool v = toboolean(-1);
         result = variant_t(v);
-    } else if (js_isnumber(vm, -1)) {
-        const float f = js_tonumber(vm, -1);
+    } else if (isnumber(-1)) {
+        const float f = tonumber(-1);
         result = variant_t(f);
-    } else if (js_isobject(vm, -1)) {
+    } else if (isobject(-1)) {
         result = variant_t(variant_object_t{ name });
-    } else if (js_isarray(vm, -1)) {
+    } else if (isarray(-1)) {
         result = variant_t(variant_array_t{ name });
     }
 
@@ -182,77 +252,70 @@ archive::variant_t archive::to_variant() {
 }
 
 archive::variant_t archive::r_variant(pcstr name) {
-    auto vm = (js_State *)state;
-
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     variant_t result;
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         result = variant_t(variant_none_t{name});
-    } else if (js_isstring(vm, -1)) {
-        const xstring str = js_tostring(vm, -1);
+    } else if (isstring(-1)) {
+        const xstring str = tostring(-1);
         result = variant_t(str);
-    } else if (js_isboolean(vm, -1)) {
-        const bool v = js_toboolean(vm, -1);
+    } else if (isboolean(-1)) {
+        const bool v = toboolean(-1);
         result = variant_t(v);
-    } else if (js_isnumber(vm, -1)) {
-        const float f = js_tonumber(vm, -1);
+    } else if (isnumber(-1)) {
+        const float f = tonumber(-1);
         result = variant_t(f);
-    } else if (js_isobject(vm, -1)) {
+    } else if (isobject(-1)) {
         result = variant_t(variant_object_t{ name });
-    } else if (js_isarray(vm, -1)) {
+    } else if (isarray(-1)) {
         result = variant_t(variant_array_t{ name });
     }
-    js_pop(vm, 1);
+    pop(1);
 
     return result;
 }
 
 std::vector<vec2i> archive::r_array_vec2i(pcstr name) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     std::vector<vec2i> result;
-    if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
+    if (isarray(-1)) {
+        int length = getlength(-1);
         for (int i = 0; i < length; ++i) {
-            js_getindex(vm, -1, i);
+            getindex(-1, i);
             vec2i v = r_vec2i_impl("x", "y");
             result.push_back(v);
-            js_pop(vm, 1);
+            pop(1);
         }
-        js_pop(vm, 1);
+        pop(1);
     }
     return result;
 }
 
 int archive::r_int(pcstr name, int def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    int result = js_isundefined(vm, -1) ? def : js_tointeger(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    int result = isundefined(-1) ? def : tointeger(-1);
+    pop(1);
     return result;
 }
 
 float archive::r_float(pcstr name, float def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    float result = js_isundefined(vm, -1) ? def : (float)js_tonumber(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    float result = isundefined(-1) ? def : (float)tonumber(-1);
+    pop(1);
     return result;
 }
 
 uint32_t archive::r_uint(pcstr name, uint32_t def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    uint32_t result = js_isundefined(vm, -1) ? def : js_touint32(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    uint32_t result = isundefined(-1) ? def : touint32(-1);
+    pop(1);
     return result;
 }
 
 bool archive::r_bool(pcstr name, bool def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    bool result = js_isundefined(vm, -1) ? def : js_toboolean(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    bool result = isundefined(-1) ? def : toboolean(-1);
+    pop(1);
     return result;
 }
 
@@ -261,20 +324,19 @@ vec2i archive::r_size2i(pcstr name, pcstr w, pcstr h) {
 }
 
 vec2i archive::r_vec2i_impl(pcstr x, pcstr y) {
-    auto vm = (js_State *)state;
     vec2i result(0, 0);
-    if (js_isobject(vm, -1)) {
-        if (js_isarray(vm, -1)) {
-            int length = js_getlength(vm, -1);
+    if (isobject(-1)) {
+        if (isarray(-1)) {
+            int length = getlength(-1);
             if (length > 0) {
-                js_getindex(vm, -1, 0); result.x = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+                getindex(-1, 0); result.x = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
                 if (length > 1) {
-                    js_getindex(vm, -1, 1); result.y = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+                    getindex(-1, 1); result.y = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
                 }
             }
         } else {
-            js_getproperty(vm, -1, x); result.x = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
-            js_getproperty(vm, -1, y); result.y = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+            getproperty(-1, x); result.x = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
+            getproperty(-1, y); result.y = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
         }
     }
 
@@ -282,53 +344,64 @@ vec2i archive::r_vec2i_impl(pcstr x, pcstr y) {
 }
 
 vec2i archive::r_vec2i(pcstr name, pcstr x, pcstr y) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     vec2i result = r_vec2i_impl(x, y);
-    js_pop(vm, 1);
+    pop(1);
 
     return result;
 }
 
 bool archive::r_anim(pcstr name, animation_t &anim) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     bool ok = false;
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         ;
-    } else if (js_isobject(vm, -1)) {
-        js_getproperty(vm, -1, "pack"); anim.pack = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "id"); anim.iid = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "offset"); anim.offset = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "duration"); anim.duration = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "max_frames"); anim.max_frames = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
+    } else if (isobject(-1)) {
+        getproperty(-1, "pack"); anim.pack = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "id"); anim.iid = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "offset"); anim.offset = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "duration"); anim.duration = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "max_frames"); anim.max_frames = isundefined(-1) ? 0 : tointeger(-1); pop(1);
         ok = true;
     }
-    js_pop(vm, 1);
+    pop(1);
     return ok;
 }
 
 bool archive::r_desc(pcstr name, image_desc &desc) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     bool ok = false;
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         ;
-    } else if (js_isobject(vm, -1)) {
-        js_getproperty(vm, -1, "pack"); desc.pack = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "id"); desc.id = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "offset"); desc.offset = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
+    } else if (isobject(-1)) {
+        getproperty(-1, "pack"); desc.pack = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "id"); desc.id = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "offset"); desc.offset = isundefined(-1) ? 0 : tointeger(-1); pop(1);
         ok = true;
     }
-    js_pop(vm, 1);
+    pop(1);
     return ok;
 }
 
+void g_archive::getglobal(pcstr name) {
+    if (reads) {
+        const xstring section(name);
+        if (std::find(reads->begin(), reads->end(), section) == reads->end()) {
+            reads->push_back(section);
+        }
+    }
+    archive::getglobal(name);
+}
+
 void g_archive::w_property(pcstr name, pcstr prop, const xstring &value) {
     if (!state) {
         return;
     }
 
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->write(name, prop, value);
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
@@ -346,6 +419,10 @@ void g_archive::w_property(pcstr name, pcstr prop, bool value) {
         return;
     }
 
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->write(name, prop, value);
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
@@ -363,6 +440,10 @@ void g_archive::w_property(pcstr name, pcstr prop, float value) {
         return;
     }
 
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->write(name, prop, value);
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
@@ -380,6 +461,10 @@ void g_archive::w_property(pcstr name, pcstr prop, vec2i value) {
         return;
     }
 
+    if (auto snapshot = archive_snapshot::from(state)) {
+        return snapshot->write(name, prop, value);
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
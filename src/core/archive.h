@@ -12,6 +12,7 @@
 struct animation_t;
 struct image_desc;
 
+// reads the script vm stack, or an archive_snapshot of it when state is the active snapshot
 struct archive {
     void *state = nullptr;
     inline archive(void *_vm) : state(_vm) {}
@@ -269,10 +270,13 @@ protected:
     bool isarray(int idx);
     int getlength(int idx);
     void getindex(int idx, int i);
+    bool isundefined(int idx);
     bool isnumber(int idx);
     bool isstring(int idx);
     bool isboolean(int idx);
     double tonumber(int idx);
+    int tointeger(int idx);
+    uint32_t touint32(int idx);
     pcstr tostring(int idx);
     bool toboolean(int idx);
     void pop(int num);
@@ -356,6 +360,12 @@ struct g_archive : public archive {
         }
         pop(1);
     }
+    // top level sections read while this is set are added to it, config::refresh()
+    // uses that to know which sections every config handler depends on
+    static inline std::vector<xstring> *reads = nullptr;
+
+protected:
+    void getglobal(pcstr name);
 };
 
 extern g_archive g_config_arch;
\ No newline at end of file
@@ -0,0 +1,584 @@
+#include "archive_snapshot.h"
+
+#include "core/archive.h"
+#include "core/log.h"
+#include "content/vfs.h"
+
+#include "mujs/mujs.h"
+#include "mujs/jsi.h"
+#include "mujs/jsvalue.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+archive_snapshot *archive_snapshot::active = nullptr;
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53434b41; // "AKCS"
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr int SNAPSHOT_MAX_DEPTH = 32;
+
+struct snapshot_writer {
+    std::vector<uint8_t> data;
+
+    template<typename T>
+    void put(T v) {
+        const size_t at = data.size();
+        data.resize(at + sizeof(T));
+        memcpy(data.data() + at, &v, sizeof(T));
+    }
+
+    void put_str(const std::string &s) {
+        put<uint32_t>((uint32_t)s.size());
+        data.insert(data.end(), s.begin(), s.end());
+    }
+};
+
+struct snapshot_reader {
+    const uint8_t *data;
+    size_t size;
+    size_t pos = 0;
+    bool ok = true;
+
+    template<typename T>
+    T get() {
+        T v{};
+        if (pos + sizeof(T) > size) {
+            ok = false;
+            return v;
+        }
+        memcpy(&v, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    }
+
+    std::string get_str() {
+        const uint32_t len = get<uint32_t>();
+        if (!ok || pos + len > size) {
+            ok = false;
+            return {};
+        }
+        std::string s((const char *)data + pos, len);
+        pos += len;
+        return s;
+    }
+};
+
+// ToString() of a number the way the script side prints it
+pcstr snapshot_number_to_string(char *buf, double n) {
+    if (std::isnan(n)) return "NaN";
+    if (std::isinf(n)) return n < 0 ? "-Infinity" : "Infinity";
+    if (n == 0) return "0";
+
+    if (n == std::floor(n) && std::fabs(n) < 1e21) {
+        snprintf(buf, 32, "%.0f", n);
+        return buf;
+    }
+
+    for (int precision = 15; precision <= 17; ++precision) {
+        snprintf(buf, 32, "%.*g", precision, n);
+        if (strtod(buf, nullptr) == n) {
+            break;
+        }
+    }
+    return buf;
+}
+
+double snapshot_string_to_number(pcstr s) {
+    while (isspace((unsigned char)*s)) ++s;
+    if (!*s) return 0;
+
+    char *e = nullptr;
+    double n;
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X') && s[2]) {
+        n = (double)strtol(s + 2, &e, 16);
+    } else if (!strncmp(s, "Infinity", 8) || !strncmp(s, "+Infinity", 9) || !strncmp(s, "-Infinity", 9)) {
+        n = (*s == '-') ? -INFINITY : INFINITY;
+        e = (char *)s + (*s == 'I' ? 8 : 9);
+    } else {
+        n = strtod(s, &e);
+    }
+
+    while (isspace((unsigned char)*e)) ++e;
+    return *e ? NAN : n;
+}
+
+} // namespace
+
+uint32_t archive_snapshot::add_string(pcstr s, size_t len) {
+    const uint32_t offset = (uint32_t)strings.size();
+    strings.insert(strings.end(), s, s + len);
+    strings.push_back(0);
+    return offset;
+}
+
+void archive_snapshot::index_globals() {
+    globals.clear();
+    const node_t &root = nodes[0];
+    for (uint32_t i = 0; i < root.count; ++i) {
+        globals[str(nodes[root.first + i].key)] = root.first + i;
+    }
+}
+
+bool archive_snapshot::has_child(uint32_t parent, pcstr name) const {
+    const node_t &n = nodes[parent];
+    if (n.type != node_object) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < n.count; ++i) {
+        if (!strcmp(str(nodes[n.first + i].key), name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int32_t archive_snapshot::lookup(int32_t parent, pcstr name) const {
+    if (parent < 0) {
+        return -1;
+    }
+
+    for (auto it = overrides.rbegin(); it != overrides.rend(); ++it) {
+        if (it->parent == (uint32_t)parent && it->key == name) {
+            return it->node;
+        }
+    }
+
+    if (parent == 0) {
+        auto it = globals.find(name);
+        return (it != globals.end()) ? (int32_t)it->second : -1;
+    }
+
+    const node_t &n = nodes[parent];
+    if (n.type == node_array) {
+        char *e = nullptr;
+        const long i = strtol(name, &e, 10);
+        return (*name && !*e && i >= 0 && i < (long)n.count) ? (int32_t)(n.first + i) : -1;
+    }
+
+    if (n.type != node_object) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < n.count; ++i) {
+        if (!strcmp(str(nodes[n.first + i].key), name)) {
+            return n.first + i;
+        }
+    }
+    return -1;
+}
+
+void archive_snapshot::getglobal(pcstr name) {
+    stack.push_back({lookup(0, name), -1});
+}
+
+void archive_snapshot::getproperty(int idx, pcstr name) {
+    stack.push_back({lookup(at(idx).node, name), -1});
+}
+
+void archive_snapshot::getindex(int idx, int i) {
+    const int32_t parent = at(idx).node;
+    int32_t child = -1;
+    if (parent >= 0 && nodes[parent].type == node_array) {
+        child = (i >= 0 && (uint32_t)i < nodes[parent].count) ? (int32_t)(nodes[parent].first + i) : -1;
+    } else if (parent >= 0) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%d", i);
+        child = lookup(parent, buf);
+    }
+    stack.push_back({child, -1});
+}
+
+int archive_snapshot::getlength(int idx) {
+    const int32_t n = at(idx).node;
+    if (n < 0) {
+        return 0;
+    }
+
+    if (nodes[n].type == node_array) {
+        return nodes[n].count;
+    }
+
+    const int32_t length = lookup(n, "length");
+    return length >= 0 ? (int)nodes[length].number : 0;
+}
+
+archive_snapshot::e_node archive_snapshot::type(int idx) const {
+    const int32_t n = at(idx).node;
+    return n < 0 ? node_undefined : (e_node)nodes[n].type;
+}
+
+double archive_snapshot::tonumber(int idx) const {
+    const int32_t n = at(idx).node;
+    if (n < 0) {
+        return NAN;
+    }
+
+    const node_t &v = nodes[n];
+    switch (v.type) {
+    case node_null: return 0;
+    case node_bool:
+    case node_number: return v.number;
+    case node_string: return snapshot_string_to_number(str(v.first));
+    default: return NAN;
+    }
+}
+
+pcstr archive_snapshot::tostring(int idx) {
+    const int32_t n = at(idx).node;
+    if (n < 0) {
+        return "undefined";
+    }
+
+    const node_t &v = nodes[n];
+    switch (v.type) {
+    case node_null: return "null";
+    case node_bool: return v.number ? "true" : "false";
+    case node_string: return str(v.first);
+    case node_number: {
+        char *buf = scratch[scratch_index++ % std::size(scratch)];
+        return snapshot_number_to_string(buf, v.number);
+    }
+    default: return "[object Object]";
+    }
+}
+
+bool archive_snapshot::toboolean(int idx) const {
+    const int32_t n = at(idx).node;
+    if (n < 0) {
+        return false;
+    }
+
+    const node_t &v = nodes[n];
+    switch (v.type) {
+    case node_null: return false;
+    case node_bool: return v.number != 0;
+    case node_number: return v.number != 0 && !std::isnan(v.number);
+    case node_string: return v.count > 0;
+    default: return true;
+    }
+}
+
+void archive_snapshot::pushiterator(int idx) {
+    stack.push_back({at(idx).node, 0});
+}
+
+pcstr archive_snapshot::nextiterator(int idx) {
+    slot_t &it = at(idx);
+    if (it.node < 0 || it.iter < 0) {
+        return nullptr;
+    }
+
+    const node_t &n = nodes[it.node];
+    if (n.type == node_array) {
+        if ((uint32_t)it.iter >= n.count) {
+            return nullptr;
+        }
+        char *buf = scratch[scratch_index++ % std::size(scratch)];
+        snprintf(buf, 32, "%d", it.iter++);
+        return buf;
+    }
+
+    if (n.type != node_object) {
+        return nullptr;
+    }
+
+    if ((uint32_t)it.iter < n.count) {
+        return str(nodes[n.first + it.iter++].key);
+    }
+
+    // keys added by w_property() after the children
+    for (size_t k = it.iter - n.count; k < overrides.size(); ++k) {
+        const override_t &o = overrides[k];
+        ++it.iter;
+        if (o.parent == (uint32_t)it.node && !has_child(it.node, o.key.c_str())) {
+            return o.key.c_str();
+        }
+    }
+    return nullptr;
+}
+
+void archive_snapshot::pop(int n) {
+    stack.resize(std::max<int>(0, (int)stack.size() - n));
+}
+
+void archive_snapshot::set_override(uint32_t parent, pcstr key, uint32_t node) {
+    for (auto &o : overrides) {
+        if (o.parent == parent && o.key == key) {
+            o.node = node;
+            return;
+        }
+    }
+    overrides.push_back({parent, key, node});
+}
+
+uint32_t archive_snapshot::append_value(const value_t &value) {
+    const uint32_t at = (uint32_t)nodes.size();
+    node_t n;
+    if (auto s = std::get_if<xstring>(&value)) {
+        n.type = node_string;
+        n.count = (uint32_t)strlen(s->c_str());
+        n.first = add_string(s->c_str(), n.count);
+        nodes.push_back(n);
+    } else if (auto b = std::get_if<bool>(&value)) {
+        n.type = node_bool;
+        n.number = *b ? 1 : 0;
+        nodes.push_back(n);
+    } else if (auto f = std::get_if<float>(&value)) {
+        n.type = node_number;
+        n.number = *f;
+        nodes.push_back(n);
+    } else if (auto v = std::get_if<vec2i>(&value)) {
+        n.type = node_object;
+        n.first = at + 1;
+        n.count = 2;
+        nodes.push_back(n);
+
+        node_t x;
+        x.type = node_number;
+        x.key = add_string("x", 1);
+        x.number = v->x;
+        node_t y = x;
+        y.key = add_string("y", 1);
+        y.number = v->y;
+        nodes.push_back(x);
+        nodes.push_back(y);
+    }
+    return at;
+}
+
+void archive_snapshot::write(pcstr global, pcstr prop, const value_t &value) {
+    int32_t object = lookup(0, global);
+    if (object < 0 || nodes[object].type != node_object) {
+        object = (int32_t)nodes.size();
+        node_t n;
+        n.type = node_object;
+        nodes.push_back(n);
+        set_override(0, global, object);
+    }
+
+    set_override(object, prop, append_value(value));
+    writes.push_back({global, prop, value});
+}
+
+void archive_snapshot::replay(g_archive &arch) const {
+    for (const auto &w : writes) {
+        std::visit([&] (const auto &v) { arch.w_property(w.global.c_str(), w.prop.c_str(), v); }, w.value);
+    }
+}
+
+void archive_snapshot::fill_object(js_State *J, uint32_t at, const std::vector<std::string> &keys, std::vector<const void *> &path) {
+    const uint32_t first = (uint32_t)nodes.size();
+    nodes.resize(first + keys.size());
+    nodes[at].type = node_object;
+    nodes[at].first = first;
+    nodes[at].count = (uint32_t)keys.size();
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        nodes[first + i].key = add_string(keys[i].c_str(), keys[i].size());
+        js_getproperty(J, -1, keys[i].c_str());
+        fill(J, first + (uint32_t)i, path);
+        js_pop(J, 1);
+    }
+}
+
+void archive_snapshot::fill(js_State *J, uint32_t at, std::vector<const void *> &path) {
+    node_t &n = nodes[at];
+    if (js_isundefined(J, -1)) {
+        n.type = node_undefined;
+    } else if (js_isnull(J, -1)) {
+        n.type = node_null;
+    } else if (js_isboolean(J, -1)) {
+        n.type = node_bool;
+        n.number = js_toboolean(J, -1) ? 1 : 0;
+    } else if (js_isnumber(J, -1) || js_iscnumber(J, -1)) {
+        n.type = node_number;
+        n.number = js_tonumber(J, -1);
+    } else if (js_isstring(J, -1)) {
+        pcstr s = js_tostring(J, -1);
+        const uint32_t len = (uint32_t)strlen(s);
+        const uint32_t offset = add_string(s, len);
+        nodes[at].type = node_string;
+        nodes[at].first = offset;
+        nodes[at].count = len;
+    } else if (js_isobject(J, -1)) {
+        // shared objects are stored once per reference, a cycle ends as undefined
+        const void *object = J->stack[J->top - 1].u.object;
+        if ((int)path.size() >= SNAPSHOT_MAX_DEPTH || std::find(path.begin(), path.end(), object) != path.end()) {
+            n.type = node_undefined;
+            return;
+        }
+
+        if (js_iscallable(J, -1)) {
+            n.type = node_object;
+            return;
+        }
+
+        path.push_back(object);
+        if (js_isarray(J, -1)) {
+            const int length = js_getlength(J, -1);
+            const uint32_t first = (uint32_t)nodes.size();
+            nodes.resize(first + length);
+            nodes[at].type = node_array;
+            nodes[at].first = first;
+            nodes[at].count = length;
+            for (int i = 0; i < length; ++i) {
+                js_getindex(J, -1, i);
+                fill(J, first + i, path);
+                js_pop(J, 1);
+            }
+        } else {
+            std::vector<std::string> keys;
+            pcstr key;
+            js_pushiterator(J, -1, 1);
+            while ((key = js_nextiterator(J, -1))) {
+                keys.emplace_back(key);
+            }
+            js_pop(J, 1);
+            fill_object(J, at, keys, path);
+        }
+        path.pop_back();
+    }
+}
+
+bool archive_snapshot::capture(js_State *J) {
+    nodes.clear();
+    strings.clear();
+    overrides.clear();
+    writes.clear();
+    stack.clear();
+    nodes.resize(1);
+
+    // script vars are not enumerable on the global object, walk its property list instead
+    std::vector<std::string> keys;
+    for (js_Property *p = J->G->head; p; p = p->next) {
+        keys.emplace_back(p->name);
+    }
+
+    std::vector<const void *> path;
+    js_pushglobal(J);
+    fill_object(J, 0, keys, path);
+    js_pop(J, 1);
+
+    index_globals();
+    return true;
+}
+
+bool archive_snapshot::save(pcstr filename) const {
+    snapshot_writer w;
+    w.put<uint32_t>(SNAPSHOT_MAGIC);
+    w.put<uint32_t>(SNAPSHOT_VERSION);
+    w.put_str(version);
+    w.put<int32_t>(screen.x);
+    w.put<int32_t>(screen.y);
+
+    w.put<uint32_t>((uint32_t)sources.size());
+    for (const auto &s : sources) {
+        w.put_str(s.requested);
+        w.put_str(s.resolved);
+        w.put<uint32_t>(s.crc);
+    }
+
+    w.put<uint32_t>((uint32_t)nodes.size());
+    for (const auto &n : nodes) {
+        w.put<uint8_t>(n.type);
+        w.put<uint32_t>(n.key);
+        w.put<uint32_t>(n.first);
+        w.put<uint32_t>(n.count);
+        w.put<double>(n.number);
+    }
+
+    w.put_str(std::string(strings.begin(), strings.end()));
+
+    FILE *fp = vfs::file_open_os(filename, "wb");
+    if (!fp) {
+        logs::error("config snapshot: unable to write %s", filename);
+        return false;
+    }
+
+    const bool ok = fwrite(w.data.data(), 1, w.data.size(), fp) == w.data.size();
+    vfs::file_close(fp);
+    return ok;
+}
+
+bool archive_snapshot::load(pcstr filename) {
+    FILE *fp = vfs::file_open_os(filename, "rb");
+    if (!fp) {
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    fseek(fp, 0, SEEK_END);
+    const long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size > 0) {
+        data.resize(size);
+        data.resize(fread(data.data(), 1, size, fp));
+    }
+    vfs::file_close(fp);
+
+    snapshot_reader r{data.data(), data.size()};
+    if (r.get<uint32_t>() != SNAPSHOT_MAGIC || r.get<uint32_t>() != SNAPSHOT_VERSION) {
+        return false;
+    }
+
+    version = r.get_str();
+    screen.x = r.get<int32_t>();
+    screen.y = r.get<int32_t>();
+
+    sources.resize(r.get<uint32_t>());
+    for (auto &s : sources) {
+        s.requested = r.get_str();
+        s.resolved = r.get_str();
+        s.crc = r.get<uint32_t>();
+    }
+
+    const uint32_t nodes_num = r.get<uint32_t>();
+    if (!r.ok || nodes_num == 0 || nodes_num > r.size / 21) {
+        return false;
+    }
+
+    nodes.resize(nodes_num);
+    for (auto &n : nodes) {
+        n.type = r.get<uint8_t>();
+        n.key = r.get<uint32_t>();
+        n.first = r.get<uint32_t>();
+        n.count = r.get<uint32_t>();
+        n.number = r.get<double>();
+    }
+
+    const std::string pool = r.get_str();
+    if (!r.ok || (pool.empty() && nodes_num > 1)) {
+        return false;
+    }
+    strings.assign(pool.begin(), pool.end());
+
+    // everything the readers index must stay inside the tables
+    for (const auto &n : nodes) {
+        const bool container = n.type == node_array || n.type == node_object;
+        if (n.key >= strings.size() && &n != &nodes[0]) {
+            return false;
+        }
+        if (container && (uint64_t)n.first + n.count > nodes.size()) {
+            return false;
+        }
+        if (n.type == node_string && (uint64_t)n.first + n.count >= strings.size()) {
+            return false;
+        }
+    }
+
+    if (nodes[0].type != node_object) {
+        return false;
+    }
+
+    overrides.clear();
+    writes.clear();
+    stack.clear();
+    index_globals();
+    return true;
+}
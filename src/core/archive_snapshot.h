@@ -0,0 +1,111 @@
+#pragma once
+
+#include "core/xstring.h"
+#include "core/vec2i.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+struct js_State;
+struct g_archive;
+
+// evaluated config globals flattened into one blob, so a start with unchanged scripts
+// serves archive reads without running the script vm. children of an object or array
+// are stored next to each other, the stack mimics the vm stack the archive readers walk
+struct archive_snapshot {
+    enum e_node : uint8_t {
+        node_undefined = 0,
+        node_null,
+        node_bool,
+        node_number,
+        node_string,
+        node_array,
+        node_object,
+    };
+
+    struct node_t {
+        uint8_t type = node_undefined;
+        uint32_t key = 0;   // name under the parent object, offset in the string pool
+        uint32_t first = 0; // first child, or offset of the string value in the pool
+        uint32_t count = 0; // children, or length of the string value
+        double number = 0;
+    };
+
+    struct source_t {
+        std::string requested;
+        std::string resolved;
+        uint32_t crc;
+    };
+
+    using value_t = std::variant<xstring, bool, float, vec2i>;
+    struct write_t {
+        std::string global;
+        std::string prop;
+        value_t value;
+    };
+
+    std::string version;
+    vec2i screen;
+    std::vector<source_t> sources; // scripts executed to get this state, in load order
+    std::vector<node_t> nodes;     // nodes[0] is the global object
+    std::vector<char> strings;
+    std::vector<write_t> writes;   // w_property() calls made on the snapshot, replayed when the vm starts
+
+    bool save(pcstr filename) const;
+    bool load(pcstr filename);
+    bool capture(js_State *J);
+    void replay(g_archive &arch) const;
+
+    // same meaning as the mujs functions, idx counts from the top of the stack when negative
+    void getglobal(pcstr name);
+    void getproperty(int idx, pcstr name);
+    void getindex(int idx, int i);
+    int getlength(int idx);
+    e_node type(int idx) const;
+    bool isarray(int idx) const { return type(idx) == node_array; }
+    bool isobject(int idx) const { return type(idx) >= node_array; }
+    double tonumber(int idx) const;
+    pcstr tostring(int idx);
+    bool toboolean(int idx) const;
+    void pushiterator(int idx);
+    pcstr nextiterator(int idx);
+    void pop(int n);
+
+    void write(pcstr global, pcstr prop, const value_t &value);
+
+    static archive_snapshot *active;
+    static archive_snapshot *from(void *state) { return (active && state == active) ? active : nullptr; }
+
+private:
+    struct slot_t {
+        int32_t node; // -1 for undefined
+        int32_t iter; // next key to return when the slot is an iterator
+    };
+
+    struct override_t {
+        uint32_t parent;
+        std::string key;
+        uint32_t node;
+    };
+
+    std::vector<slot_t> stack;
+    std::vector<override_t> overrides;
+    std::unordered_map<std::string, uint32_t> globals;
+    char scratch[4][32];
+    int scratch_index = 0;
+
+    const slot_t &at(int idx) const { return stack[idx < 0 ? (int)stack.size() + idx : idx]; }
+    slot_t &at(int idx) { return stack[idx < 0 ? (int)stack.size() + idx : idx]; }
+    pcstr str(uint32_t offset) const { return strings.data() + offset; }
+    uint32_t add_string(pcstr s, size_t len);
+    int32_t lookup(int32_t parent, pcstr name) const;
+    bool has_child(uint32_t parent, pcstr name) const;
+    void set_override(uint32_t parent, pcstr key, uint32_t node);
+    uint32_t append_value(const value_t &value);
+    void fill(js_State *J, uint32_t at, std::vector<const void *> &path);
+    void fill_object(js_State *J, uint32_t at, const std::vector<std::string> &keys, std::vector<const void *> &path);
+    void index_globals();
+};
@@ -6,6 +6,7 @@
 
 static random_data_t g_random_data;
 static uint32_t anti_scum_seed = 0;
+static uint32_t sim_seed = 0;
 
 const random_data_t* random_data_struct() {
     return &g_random_data;
@@ -16,6 +17,7 @@ void random_init() {
     memset(&data, 0, sizeof(data));
     data.iv1 = 0x54657687;
     data.iv2 = 0x72641663;
+    sim_seed = 0;
 }
 
 static void random_bits_fill() {
@@ -26,6 +28,7 @@ static void random_bits_fill() {
     data.random2_3bit = data.iv2 & 0x7;
     data.random2_7bit = data.iv2 & 0x7f;
     data.random2_15bit = data.iv2 & 0x7fff;
+    sim_seed = (data.iv1 * 0x9e3779b1u) ^ data.iv2;
 }
 void random_generate_next() {
     auto &data = g_random_data;
@@ -191,6 +194,23 @@ io_buffer* iob_random_iv = new io_buffer([](io_buffer* iob, size_t version) {
     random_bits_fill();
 });
 
+uint32_t random_sim_next() {
+    // xorshift32, zero is its only fixed point
+    uint32_t x = sim_seed ? sim_seed : 0x6d2b79f5u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim_seed = x;
+    return x;
+}
+
+int random_sim_between(int min, int max) {
+    if (max <= min) {
+        return min;
+    }
+    return min + (int)(random_sim_next() % (uint32_t)(max - min));
+}
+
 // used in OG Pharaoh to get non-deterministic random values
 uint16_t anti_scum_random_15bit(bool update) {
     if (update) {
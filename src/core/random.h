@@ -39,6 +39,19 @@ void randomize_event_fields(int16_t field[4], int32_t* seed);
 tile2i random_around_point(tile2i tile, tile2i src, int step, int bias, int max_dist);
 bool random_bool_lerp_scalar_int(int minimum, int maximum, int v);
 
+// deterministic stream for simulation code outside the original random sequence,
+// reseeded from iv1/iv2 so results follow the savegame instead of the wall clock
+uint32_t random_sim_next();
+int random_sim_between(int min, int max); // [min, max)
+
+// UniformRandomBitGenerator over random_sim_next() for std::shuffle and friends
+struct random_sim_engine {
+    using result_type = uint32_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+    result_type operator()() { return random_sim_next(); }
+};
+
 uint16_t anti_scum_random_15bit(bool update = true);
 bool anti_scum_random_bool();
 
@@ -5,6 +5,7 @@
 
 #include "content/vfs.h"
 #include "core/log.h"
+#include "js/js.h"
 #include "js/js_game.h"
 #include "mujs/mujs.h"
 
@@ -187,7 +188,7 @@ public:
 		svardata = "log_info(\"akhenaten: akhenaten.conf started\")\n";
 		svardata.append("var game_settings = ");
 
-		js_State *state = (js_State *)g_config_arch.state;
+		js_State *state = js_vm_state();
 		js_setdumping(state, &svarprintf);
 		js_getglobal(state, name);
 		if (js_isobject(state, -1)) {
@@ -6,13 +6,21 @@
 #include <mutex>
 #include <unordered_map>
 
-static std::mutex xstring_container_m;
-
+// values are never freed, so a docked pointer stays valid without the lock.
+// the table is split by crc so threads docking different strings rarely wait on each other
 struct xstring_container {
-    std::unordered_map<uint32_t, xstring_value *> data;
+    enum { shards_num = 16 };
+
+    struct shard_t {
+        std::mutex lock;
+        std::unordered_map<uint32_t, xstring_value *> data; // crc -> head of the collision chain
+    };
+
+    shard_t shards[shards_num];
+
     void verify();
-    void dump(FILE *f) const;
-    static xstring_value *dock(pcstr value);
+    void dump(FILE *f);
+    xstring_value *dock(pcstr value, uint32_t crc, size_t length);
     void dump();
     void clean();
 
@@ -21,79 +29,93 @@ struct xstring_container {
     }
 };
 
-xstring_container *g_xstring = nullptr;
+// created on first use and kept until exit, static xstrings are docked before main()
+static xstring_container &xstrings() {
+    static xstring_container *container = new xstring_container();
+    return *container;
+}
 
 void xstring_container::verify() {
-    std::scoped_lock _(xstring_container_m);
     logs::info("strings verify started");
-    for (const auto &it: data) {
-        const auto crc = crc32(it.second->value.c_str(), it.second->length);
-        bstring32 crc_str;
-        assert(crc == it.second->crc);// , "error: read-only memory corruption (shared_strings)"); // itoa(value->dwCRC, crc_str, 16));
-        assert(it.second->length == it.second->value.length());// , "error: read-only memory corruption (shared_strings, internal structures)");// , value->value);
+    for (auto &shard : shards) {
+        std::scoped_lock _(shard.lock);
+        for (const auto &it : shard.data) {
+            for (const xstring_value *v = it.second; v; v = v->next) {
+                const auto crc = crc32(v->value.c_str(), v->length);
+                assert(crc == v->crc && crc == it.first);// , "error: read-only memory corruption (shared_strings)");
+                assert(v->length == v->value.length());// , "error: read-only memory corruption (shared_strings, internal structures)");// , value->value);
+            }
+        }
     }
     logs::info("strings verify completed");
 }
 
-void xstring_container::dump(FILE *f) const {
-    for (const auto &it: data) {
-        fprintf(f, "ref[%4u]-len[%3u]-crc[%8X] : %s\n", it.second->reference, it.second->length, it.second->crc, it.second->value.c_str());
+void xstring_container::dump(FILE *f) {
+    for (auto &shard : shards) {
+        std::scoped_lock _(shard.lock);
+        for (const auto &it : shard.data) {
+            for (const xstring_value *v = it.second; v; v = v->next) {
+                fprintf(f, "ref[%4u]-len[%3u]-crc[%8X] : %s\n", v->reference, v->length, v->crc, v->value.c_str());
+            }
+        }
     }
 }
 
-xstring_value *xstring_container::dock(pcstr value) {
-    if (nullptr == value) {
-        return nullptr;
-    }
+xstring_value *xstring_container::dock(pcstr value, uint32_t crc, size_t length) {
+    assert(sizeof(xstring_value) + length + 1 < 4096);
 
-    std::scoped_lock _(xstring_container_m);
+    shard_t &shard = shards[crc % shards_num];
+    std::scoped_lock _(shard.lock);
 
-    if (!g_xstring) {
-        g_xstring = new xstring_container();
-        g_xstring->data.reserve(4096);
+    // equal crc is not enough, different strings may share it
+    xstring_value *&head = shard.data[crc];
+    for (xstring_value *v = head; v; v = v->next) {
+        if (v->length == length && memcmp(v->value.data(), value, length) == 0) {
+            return v;
+        }
     }
 
-    // calc len
-    const size_t s_len = strlen(value);
-    const size_t s_len_with_zero = s_len + 1;
-    assert(sizeof(xstring_value) + s_len_with_zero < 4096);
-
-    // setup find structure
-    uint16_t length = static_cast<uint32_t>(s_len);
-    uint32_t crc = crc32(value, uint32_t(s_len));
-
-    // search
-    auto it = g_xstring->data.find(crc);
+    xstring_value *new_xstr = new xstring_value;
+    new_xstr->reference = 0;
+    new_xstr->length = static_cast<uint16_t>(length);
+    new_xstr->crc = crc;
+    new_xstr->value.assign(value, length);
+    new_xstr->next = head;
+    head = new_xstr;
 
-    // it may be the case, string is not found or has "non-exact" match
-    if (it == g_xstring->data.end()) {
-        xstring_value *new_xstr = new xstring_value;
-        new_xstr->reference = 0;
-        new_xstr->length = length;
-        new_xstr->crc = crc;
-        new_xstr->value = value;
-
-        g_xstring->data.insert({crc, new_xstr});
-        return new_xstr;
-    }
-
-    return it->second;
+    return new_xstr;
 }
 
 void xstring_container::dump() {
-    std::scoped_lock _(xstring_container_m);
     FILE* F = fopen("c:\\$str_dump$.txt", "w");
     dump(F);
     fclose(F);
 }
 
 void xstring_container::clean() {
-    for (const auto &it : data) {
-        delete it.second;
+    for (auto &shard : shards) {
+        std::scoped_lock _(shard.lock);
+        for (const auto &it : shard.data) {
+            xstring_value *v = it.second;
+            while (v) {
+                xstring_value *next = v->next;
+                delete v;
+                v = next;
+            }
+        }
+        shard.data.clear();
     }
-    data.clear();
 }
 
 xstring_value *xstring::_dock(pcstr value) {
-    return xstring_container::dock(value);
-}
\ No newline at end of file
+    if (nullptr == value) {
+        return nullptr;
+    }
+
+    const size_t length = strlen(value);
+    return xstrings().dock(value, crc32(value, uint32_t(length)), length);
+}
+
+xstring_value *xstring::_dock(const xstring_literal &value) {
+    return xstrings().dock(value.value, value.crc, value.length);
+}
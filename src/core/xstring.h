@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bstring.h"
+#include "crc32.h"
 
 #include <cstdint>
 #include <cstdarg>
@@ -13,8 +14,23 @@ struct xstring_value {
     uint16_t reference;
     uint16_t length;
     std::string value;
+    xstring_value *next; // other values with the same crc
 };
 
+// string literal with crc and length taken at compile time, see XSTR()
+struct xstring_literal {
+    pcstr value;
+    uint32_t crc;
+    uint16_t length;
+};
+
+// docks the literal once per call site, later calls only copy the pointer:
+//   const animation_t &a = anim(XSTR("work"));
+#define XSTR(s) ([] () -> const xstring & { \
+        static const xstring _xstr(xstring_literal{s, std::integral_constant<uint32_t, crc32_str(s)>::value, sizeof(s) - 1}); \
+        return _xstr; \
+    }())
+
 class xstring {
     xstring_value* _p;
 
@@ -31,17 +47,9 @@ protected:
 
 public:
     xstring_value *_dock(pcstr value);
-    void _set(pcstr rhs) {
-        xstring_value* v = _dock(rhs);
-        if (0 != v) {
-            v->reference++;
-        }
-        _dec();
-        _p = v;
-    }
+    xstring_value *_dock(const xstring_literal &value);
 
-    void _set(xstring const& rhs) {
-        xstring_value* v = rhs._p;
+    void _set(xstring_value *v) {
         if (0 != v) {
             v->reference++;
         }
@@ -49,6 +57,11 @@ public:
         _p = v;
     }
 
+    void _set(pcstr rhs) { _set(_dock(rhs)); }
+    void _set(const xstring_literal &rhs) { _set(_dock(rhs)); }
+
+    void _set(xstring const& rhs) { _set(rhs._p); }
+
     [[nodiscard]]
     const xstring_value* _get() const { return _p; }
 
@@ -59,6 +72,7 @@ public:
     // construction
     xstring() { _p = nullptr; }
     xstring(pcstr rhs) { _p = nullptr; _set(rhs); }
+    xstring(const xstring_literal &rhs) { _p = nullptr; _set(rhs); }
     xstring(xstring const& rhs) { _p = 0; _set(rhs); }
     ~xstring() { _dec(); }
 
@@ -1,6 +1,7 @@
 #include "combat.h"
 
 #include "core/calc.h"
+#include "city/city.h"
 #include "city/city_figures.h"
 #include "figure/formation.h"
 #include "figure/movement.h"
@@ -8,7 +9,9 @@
 #include "figure/route.h"
 #include "game/difficulty.h"
 #include "grid/figure.h"
+#include "grid/figure_index.h"
 #include "grid/point.h"
+#include "grid/routing/routing_cache.h"
 #include "sound/sound.h"
 #include "game/game_events.h"
 
@@ -27,159 +30,131 @@ int attack_is_same_direction(int dir1, int dir2) {
     return 0;
 }
 
-int figure_combat_get_target_for_soldier(tile2i tile, int max_distance) {
-    int figure_id = 0;
-    int min_distance = 10000;
-    for (figure *f: map_figures()) {
-        if (!f->is_valid()) {
-            continue;
-        }
-
-        if (f->is_dead()) {
-            continue;
-        }
+static bool figure_combat_is_hostile(figure &f) {
+    return f.is_enemy() || f.type == FIGURE_TOMB_ROBER || f.is_attacking_native();
+}
 
-        if (f->is_enemy() || f->type == FIGURE_TOMB_ROBER || f->is_attacking_native()) {
-            int distance = calc_maximum_distance(tile, f->tile);
-            if (distance <= max_distance) {
-                if (f->targeted_by_figure_id) {
-                    distance *= 2; // penalty
-                }
-
-                if (distance < min_distance) {
-                    min_distance = distance;
-                    figure_id = f->id;
-                }
-            }
+int figure_combat_get_target_for_soldier(tile2i tile, int max_distance) {
+    auto result = g_figure_index.nearest(tile, max_distance, FIGURE_INDEX_MASK_HOSTILE, 10000, [&] (figure &f) {
+        if (!f.is_valid() || f.is_dead() || !figure_combat_is_hostile(f)) {
+            return -1;
         }
-    }
-    if (figure_id)
-        return figure_id;
 
-    for (figure *f: map_figures()) {
-        if (!f->is_valid()) {
-            continue;
+        int distance = calc_maximum_distance(tile, f.tile);
+        if (distance > max_distance) {
+            return -1;
         }
 
-        if (f->is_dead()) {
-            continue;
+        if (f.targeted_by_figure_id) {
+            distance *= 2; // penalty
         }
+        return distance;
+    });
 
-        if (f->is_enemy() || f->type == FIGURE_TOMB_ROBER || f->is_attacking_native())
-            return f->id;
+    if (result.id) {
+        return result.id;
     }
-    return 0;
+
+    return g_figure_index.lowest(FIGURE_INDEX_MASK_HOSTILE, [] (figure &f) {
+        return !f.is_dead() && figure_combat_is_hostile(f);
+    });
 }
 
 int figure_combat_get_target_for_enemy(tile2i tile) {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (figure* f: map_figures()) {
-        if (!f->is_valid() || f->is_dead()) {
-            continue;
+    auto result = g_figure_index.nearest(tile, -1, FIGURE_INDEX_MASK_SOLDIER, 10000, [&] (figure &f) {
+        if (!f.is_valid() || f.is_dead() || f.targeted_by_figure_id || !::smart_cast<figure_soldier>(&f)) {
+            return -1;
         }
 
-        if (!f->targeted_by_figure_id && ::smart_cast<figure_soldier>(f)) {
-            int distance = calc_maximum_distance(tile, f->tile);
-            if (distance < min_distance) {
-                min_distance = distance;
-                min_figure_id = f->id;
-            }
-        }
-    }
+        return calc_maximum_distance(tile, f.tile);
+    });
 
-    if (min_figure_id) {
-        return min_figure_id;
+    if (result.id) {
+        return result.id;
     }
 
     // no 'free' soldier found, take first one
-    for (figure* f: map_figures()) {
-        if (!f->is_valid() || f->is_dead()) {
-            continue;
-        }
-
-        if (::smart_cast<figure_soldier>(f)) {
-            return f->id;
-        }
-    }
-    return 0;
+    return g_figure_index.lowest(FIGURE_INDEX_MASK_SOLDIER, [] (figure &f) {
+        return !f.is_dead() && !!::smart_cast<figure_soldier>(&f);
+    });
 }
 
 int figure_combat_get_missile_target_for_soldier(figure* shooter, int max_distance, tile2i* tile) {
-    int min_distance = max_distance;
-    figure* min_figure = 0;
-    for (figure* f: map_figures()) {
-        if (!f->is_valid() || f->is_dead()) {
-            continue;
+    const tile2i from = shooter->tile;
+    auto result = g_figure_index.nearest(from, max_distance, FIGURE_INDEX_MASK_HOSTILE | FIGURE_INDEX_MASK_ANIMAL, max_distance, [&] (figure &f) {
+        if (!f.is_valid() || f.is_dead()) {
+            return -1;
         }
 
-        if (f->is_enemy() || f->is_herd() || f->is_attacking_native()) {
-            int distance = calc_maximum_distance(shooter->tile, f->tile);
-            if (distance < min_distance && figure_movement_can_launch_cross_country_missile(shooter->tile, f->tile)) {
-                min_distance = distance;
-                min_figure = f;
-            }
+        if (!f.is_enemy() && !f.is_herd() && !f.is_attacking_native()) {
+            return -1;
         }
-    }
 
-    if (min_figure) {
-        map_point_store_result(min_figure->tile, *tile);
-        return min_figure->id;
+        return calc_maximum_distance(from, f.tile);
+    }, [&] (figure &f) {
+        return !!figure_movement_can_launch_cross_country_missile(from, f.tile);
+    });
+
+    if (result.id) {
+        map_point_store_result(figure_get(result.id)->tile, *tile);
+        return result.id;
     }
 
     return 0;
 }
-int figure_combat_get_missile_target_for_enemy(figure* enemy, int max_distance, int attack_citizens, tile2i* tile) {
-    figure* min_figure = 0;
-    int min_distance = max_distance;
-    for (figure* f: map_figures()) {
-        if (!f->is_valid() || f->is_dead()) {
-            continue;
-        }
 
-        switch (f->type) {
-        default:
-            ; // nothing
-            break;
+static bool figure_combat_is_missile_proof(figure &f) {
+    switch (f.type) {
+    case FIGURE_EXPLOSION:
+    case FIGURE_STANDARD_BEARER:
+    case FIGURE_MAP_FLAG:
+    case FIGURE_FLOTSAM:
+    case FIGURE_INDIGENOUS_NATIVE:
+    case FIGURE_NATIVE_TRADER:
+    case FIGURE_ARROW:
+    case FIGURE_JAVELIN:
+    case FIGURE_BOLT:
+    case FIGURE_BALLISTA:
+    case FIGURE_CREATURE:
+    case FIGURE_FISHING_POINT:
+    case FIGURE_FISHING_SPOT:
+    case FIGURE_SHIPWRECK:
+    case FIGURE_BIRDS:
+    // case FIGURE_WOLF:
+    case FIGURE_OSTRICH:
+    case FIGURE_ANTELOPE:
+    case FIGURE_SPEAR:
+        return true;
+
+    default:
+        return false;
+    }
+}
 
-        case FIGURE_EXPLOSION:
-        case FIGURE_STANDARD_BEARER:
-        case FIGURE_MAP_FLAG:
-        case FIGURE_FLOTSAM:
-        case FIGURE_INDIGENOUS_NATIVE:
-        case FIGURE_NATIVE_TRADER:
-        case FIGURE_ARROW:
-        case FIGURE_JAVELIN:
-        case FIGURE_BOLT:
-        case FIGURE_BALLISTA:
-        case FIGURE_CREATURE:
-        case FIGURE_FISHING_POINT:
-        case FIGURE_FISHING_SPOT:
-        case FIGURE_SHIPWRECK:
-        case FIGURE_BIRDS:
-        // case FIGURE_WOLF:
-        case FIGURE_OSTRICH:
-        case FIGURE_ANTELOPE:
-        case FIGURE_SPEAR:
-            continue;
+int figure_combat_get_missile_target_for_enemy(figure* enemy, int max_distance, int attack_citizens, tile2i* tile) {
+    const tile2i from = enemy->tile;
+    const int mask = attack_citizens ? FIGURE_INDEX_MASK_ALL : FIGURE_INDEX_MASK_SOLDIER;
+    auto result = g_figure_index.nearest(from, max_distance, mask, max_distance, [&] (figure &f) {
+        if (!f.is_valid() || f.is_dead() || figure_combat_is_missile_proof(f)) {
+            return -1;
         }
-        int distance;
-        if (::smart_cast<figure_soldier>(f)) {
-            distance = calc_maximum_distance(enemy->tile, f->tile);
-        } else if (attack_citizens && f->is_friendly) {
-            distance = calc_maximum_distance(enemy->tile, f->tile) + 5;
-        } else {
-            continue;
+
+        if (::smart_cast<figure_soldier>(&f)) {
+            return calc_maximum_distance(from, f.tile);
         }
-        if (distance < min_distance
-            && figure_movement_can_launch_cross_country_missile(enemy->tile, f->tile)) {
-            min_distance = distance;
-            min_figure = f;
+
+        if (attack_citizens && f.is_friendly) {
+            return calc_maximum_distance(from, f.tile) + 5;
         }
-    }
-    if (min_figure) {
-        map_point_store_result(min_figure->tile, *tile);
-        return min_figure->id;
+
+        return -1;
+    }, [&] (figure &f) {
+        return !!figure_movement_can_launch_cross_country_missile(from, f.tile);
+    });
+
+    if (result.id) {
+        map_point_store_result(figure_get(result.id)->tile, *tile);
+        return result.id;
     }
     return 0;
 }
@@ -350,6 +325,10 @@ void figure::figure_combat_attack_figure_at(int grid_offset) {
             attack = 0;
 
         if (attack) {
+            // paths cached before the fight did not route around these tiles
+            g_city.figures.fighting += (opponent->action_state != FIGURE_ACTION_150_ATTACK) ? 2 : 1;
+            g_routing_cache.terrain_changed();
+
             action_state_before_attack = action_state;
             action_state = FIGURE_ACTION_150_ATTACK;
             opponent_id = opponent_id;
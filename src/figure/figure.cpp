@@ -13,6 +13,7 @@
 #include "figure/route.h"
 #include "figure/trader.h"
 #include "grid/figure.h"
+#include "grid/figure_index.h"
 #include "grid/grid.h"
 #include "grid/terrain.h"
 #include "io/io_buffer.h"
@@ -122,20 +123,23 @@ static int get_nearest_enemy(int x, int y, int *distance) {
 }
 
 int figure::is_nearby(int category, int *distance, int max_distance, bool gang_on) {
-    int figure_id = 0;
-    int lowest_distance = max_distance;
-    for (int i = 1; i < MAX_FIGURES; i++) {
-        figure *f = figure_get(i);
-        if (f->is_dead()) {
-            continue;
+    int mask = FIGURE_INDEX_MASK_ALL;
+    switch (category) {
+    case NEARBY_ANIMAL: mask = FIGURE_INDEX_MASK_ANIMAL | FIGURE_INDEX_MASK_HOSTILE; break;
+    case NEARBY_HOSTILE: mask = FIGURE_INDEX_MASK_HOSTILE; break;
+    }
+
+    auto result = g_figure_index.nearest(tile, max_distance, mask, max_distance, [&] (figure &f) {
+        if (f.is_dead()) {
+            return -1;
         }
 
-        if (!gang_on && f->targeted_by_figure_id) {
-            continue;
+        if (!gang_on && f.targeted_by_figure_id) {
+            return -1;
         }
 
         bool category_check = false;
-        auto props = figure_properties_for_type(f->type);
+        auto props = figure_properties_for_type(f.type);
         switch (category) {
         case NEARBY_ANY: // any dude
             if (props->category != 0)
@@ -143,46 +147,44 @@ int figure::is_nearby(int category, int *distance, int max_distance, bool gang_o
             break;
 
         case NEARBY_ANIMAL: // animal
-            if (props->category == 6 || f->is_herd())
+            if (props->category == 6 || f.is_herd())
                 category_check = true;
             break;
 
         case NEARBY_HOSTILE: // hostile
-            if (f->is_enemy() || f->type == FIGURE_TOMB_ROBER || f->is_attacking_native())
+            if (f.is_enemy() || f.type == FIGURE_TOMB_ROBER || f.is_attacking_native())
                 category_check = true;
             break;
         }
 
+        if (!category_check) {
+            return -1;
+        }
+
         // pass on to inner distance check
-        if (category_check) {
-            int dist = calc_maximum_distance(tile, f->tile);
-            if (dist <= max_distance) {
-                if (f->targeted_by_figure_id)
-                    dist *= 2; // penalty
-                if (category == NEARBY_HOSTILE) {
-                    if (f->type == FIGURE_TOMB_ROBER || f->type == FIGURE_ENEMY54_GLADIATOR)
-                        dist = calc_maximum_distance(tile, f->tile);
-                    else if (f->type == FIGURE_INDIGENOUS_NATIVE
-                        && f->action_state == FIGURE_ACTION_159_NATIVE_ATTACKING)
-                        dist = calc_maximum_distance(tile, f->tile);
-                    else if (f->is_enemy())
-                        dist = 3 * calc_maximum_distance(tile, f->tile);
-                    // else if (f->type == FIGURE_WOLF)
-                    //     dist = 4 * calc_maximum_distance(tile.x(), tile.y(), f->tile.x(), f->tile.y());
-                    //                    else
-                    //                        continue;
-                }
-                if (dist < lowest_distance) {
-                    lowest_distance = dist;
-                    figure_id = i;
-                    //                    if (!gang_on)
-                    //                        return figure_id;
-                }
-            }
+        int dist = calc_maximum_distance(tile, f.tile);
+        if (dist > max_distance) {
+            return -1;
         }
-    }
-    *distance = lowest_distance;
-    return figure_id;
+
+        if (f.targeted_by_figure_id)
+            dist *= 2; // penalty
+        if (category == NEARBY_HOSTILE) {
+            if (f.type == FIGURE_TOMB_ROBER || f.type == FIGURE_ENEMY54_GLADIATOR)
+                dist = calc_maximum_distance(tile, f.tile);
+            else if (f.type == FIGURE_INDIGENOUS_NATIVE
+                && f.action_state == FIGURE_ACTION_159_NATIVE_ATTACKING)
+                dist = calc_maximum_distance(tile, f.tile);
+            else if (f.is_enemy())
+                dist = 3 * calc_maximum_distance(tile, f.tile);
+            // else if (f.type == FIGURE_WOLF)
+            //     dist = 4 * calc_maximum_distance(tile.x(), tile.y(), f.tile.x(), f.tile.y());
+        }
+        return dist;
+    });
+
+    *distance = result.score;
+    return result.id;
 }
 
 bool figure::do_goto(tile2i dest, int terrainchoice, short NEXT_ACTION, short FAIL_ACTION) {
@@ -271,6 +273,7 @@ void figure::figure_delete_UNSAFE() {
     state = FIGURE_STATE_NONE;
     memset(this, 0, sizeof(figure));
     id = figure_id;
+    map_figure_index_remove(figure_id);
 }
 
 figure_impl *figure::dcast() {
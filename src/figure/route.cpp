@@ -1,58 +1,159 @@
 #include "route.h"
 
+#include "city/city.h"
 #include "city/city_figures.h"
 #include "grid/routing/queue.h"
 #include "grid/routing/routing.h"
+#include "grid/routing/routing_cache.h"
 
 #include "core/calc.h"
 #include "core/random.h"
 #include "grid/grid.h"
 #include "grid/figure.h"
+#include "grid/figure_index.h"
 #include "grid/random.h"
 #include "grid/routing/routing.h"
 
 #include <assert.h>
 
+#include <vector>
+
 #define MAX_ROUTES 3000
 
+// paths live in a shared byte pool, carved into blocks of 16 << size_class bytes,
+// so a ten-tile walk does not pin a full MAX_PATH_LENGTH row
 struct figure_route_data_t {
+    enum { MIN_BLOCK_SIZE = 16, NUM_SIZE_CLASSES = 6 };
+
+    struct slot_t {
+        uint32_t offset;
+        uint16_t length;
+        int8_t size_class;
+    };
+
     int figure_ids[MAX_ROUTES];
-    uint8_t direction_paths[MAX_ROUTES][MAX_PATH_LENGTH];
+    slot_t slots[MAX_ROUTES];
+    std::vector<uint16_t> free_ids;
+    std::vector<uint8_t> pool;
+    std::vector<uint32_t> free_blocks[NUM_SIZE_CLASSES];
+
+    figure_route_data_t() { reset(); }
+
+    void reset();
+    void rebuild_free_ids();
+    int acquire();
+    void release(int path_id);
+    uint8_t *assign_path(int path_id, int length);
 };
 
 figure_route_data_t g_figure_route_data;
 
-void figure_route_clear_all(void) {
-    auto &data = g_figure_route_data;
+static_assert(MAX_PATH_LENGTH <= (figure_route_data_t::MIN_BLOCK_SIZE << (figure_route_data_t::NUM_SIZE_CLASSES - 1)), "largest block must fit a full path");
+
+static int route_size_class(int length) {
+    int size_class = 0;
+    while ((figure_route_data_t::MIN_BLOCK_SIZE << size_class) < length) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+void figure_route_data_t::reset() {
     for (int i = 0; i < MAX_ROUTES; i++) {
-        data.figure_ids[i] = 0;
-        for (int j = 0; j < MAX_PATH_LENGTH; j++) {
-            data.direction_paths[i][j] = 0;
+        figure_ids[i] = 0;
+        slots[i] = {0, 0, -1};
+    }
+
+    pool.clear();
+    for (auto &blocks : free_blocks) {
+        blocks.clear();
+    }
+    rebuild_free_ids();
+}
+
+void figure_route_data_t::rebuild_free_ids() {
+    free_ids.clear();
+    // pushed in reverse so the lowest id is handed out first, as the old linear scan did
+    for (int i = MAX_ROUTES - 1; i > 0; i--) {
+        if (figure_ids[i] == 0) {
+            free_ids.push_back(i);
         }
     }
 }
 
+int figure_route_data_t::acquire() {
+    if (free_ids.empty()) {
+        return 0;
+    }
+
+    int path_id = free_ids.back();
+    free_ids.pop_back();
+    return path_id;
+}
+
+void figure_route_data_t::release(int path_id) {
+    slot_t &slot = slots[path_id];
+    if (slot.size_class >= 0) {
+        free_blocks[slot.size_class].push_back(slot.offset);
+    }
+
+    slot = {0, 0, -1};
+    figure_ids[path_id] = 0;
+    free_ids.push_back(path_id);
+}
+
+uint8_t *figure_route_data_t::assign_path(int path_id, int length) {
+    slot_t &slot = slots[path_id];
+    const int size_class = route_size_class(length);
+    if (slot.size_class != size_class) {
+        if (slot.size_class >= 0) {
+            free_blocks[slot.size_class].push_back(slot.offset);
+        }
+
+        auto &blocks = free_blocks[size_class];
+        if (!blocks.empty()) {
+            slot.offset = blocks.back();
+            blocks.pop_back();
+        } else {
+            slot.offset = (uint32_t)pool.size();
+            pool.resize(pool.size() + (MIN_BLOCK_SIZE << size_class));
+        }
+        slot.size_class = size_class;
+    }
+
+    slot.length = length;
+    return &pool[slot.offset];
+}
+
+void figure_route_clear_all(void) {
+    g_figure_route_data.reset();
+}
+
 void figure_route_clean(void) {
     auto &data = g_figure_route_data;
-    for (int i = 0; i < MAX_ROUTES; i++) {
+    for (int i = 1; i < MAX_ROUTES; i++) {
         int figure_id = data.figure_ids[i];
         if (figure_id > 0 && figure_id < MAX_FIGURES) {
-            const figure* f = figure_get(figure_id);
-            if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != i)
-                data.figure_ids[i] = 0;
+            figure* f = figure_get(figure_id);
+            if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != i) {
+                data.release(i);
+            } else if (f->routing_path_length > 0 && f->routing_path_length < data.slots[i].length) {
+                // loaded paths come in as full rows, trim them down to the walked length
+                uint8_t path[MAX_PATH_LENGTH];
+                std::copy_n(&data.pool[data.slots[i].offset], f->routing_path_length, path);
+                std::copy_n(path, f->routing_path_length, data.assign_path(i, f->routing_path_length));
+            }
         }
     }
 }
+
 int map_routing_get_first_available_id() {
     auto &data = g_figure_route_data;
-    for (int i = 1; i < MAX_ROUTES; i++) {
-        if (data.figure_ids[i] == 0)
-            return i;
-    }
-    return 0;
+    return data.free_ids.empty() ? 0 : data.free_ids.back();
 }
 
 void figure::map_figure_add() {
+    map_figure_index_update(*this);
     if (!map_grid_is_valid_offset(tile)) {
         return;
     }
@@ -122,25 +223,53 @@ void figure::map_figure_remove() {
     next_figure = 0;
 }
 
+static bool route_cache_allowed(figure &f) {
+    if (f.can_move_by_water() && f.is_boat()) {
+        return false;
+    }
+
+    switch (f.terrain_usage) {
+    case TERRAIN_USAGE_ANY:
+    case TERRAIN_USAGE_ROADS:
+    case TERRAIN_USAGE_PREFER_ROADS:
+        // citizens avoid tiles with fighting friendlies, and friendlies also fight animals and natives
+        return g_city.figures.fighting == 0 && g_city.figures.enemies == 0 && g_city.figures.rioters == 0;
+
+    default:
+        return false;
+    }
+}
+
+static const routing_cache_t::path_t *route_cache_lookup(figure &f) {
+    if (!route_cache_allowed(f)) {
+        return nullptr;
+    }
+
+    return g_routing_cache.find(f.tile, f.destination_tile, f.terrain_usage);
+}
+
 void figure::figure_route_add() {
     auto &data = g_figure_route_data;
     routing_path_id = 0;
     routing_path_current_tile = 0;
     routing_path_length = 0;
-    int path_id = map_routing_get_first_available_id();
-    if (!path_id) {
+    if (!map_routing_get_first_available_id()) {
         return;
     }
 
+    uint8_t path[MAX_PATH_LENGTH];
     int path_length;
     if (can_move_by_water() && is_boat()) {
         if (allow_move_type == EMOVE_DEEPWATER) { // flotsam
-            map_routing_calculate_distances_deepwater(tile);
-            path_length = map_routing_get_path_on_water(data.direction_paths[path_id], destination_tile, true);
+            map_routing_calculate_distances_deepwater(tile, destination_tile);
+            path_length = map_routing_get_path_on_water(path, destination_tile, true);
         } else {
             map_routing_calculate_distances_water_boat(tile);
-            path_length = map_routing_get_path_on_water(data.direction_paths[path_id], destination_tile, false);
+            path_length = map_routing_get_path_on_water(path, destination_tile, false);
         }
+    } else if (const auto *cached = route_cache_lookup(*this)) {
+        path_length = std::min<int>(cached->size(), MAX_PATH_LENGTH);
+        std::copy_n(cached->begin(), path_length, path);
     } else {
         // land figure
         int can_travel;
@@ -180,21 +309,27 @@ void figure::figure_route_add() {
 
         if (can_travel) {
             if (terrain_usage == TERRAIN_USAGE_WALLS) {
-                path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 4);
+                path_length = map_routing_get_path(path, tile, destination_tile, 4);
                 if (path_length <= 0) {
-                    path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 8);
+                    path_length = map_routing_get_path(path, tile, destination_tile, 8);
                 }
             } else if (terrain_usage == TERRAIN_USAGE_ROADS) {
-                path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 4);
+                path_length = map_routing_get_path(path, tile, destination_tile, 4);
             } else {
-                path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 8);
+                path_length = map_routing_get_path(path, tile, destination_tile, 8);
             }
         } else { // cannot travel
             path_length = 0;
         }
+
+        if (path_length > 0 && route_cache_allowed(*this)) {
+            g_routing_cache.store(tile, destination_tile, terrain_usage, path, path_length);
+        }
     }
 
-    if (path_length) {
+    if (path_length > 0) {
+        int path_id = data.acquire();
+        std::copy_n(path, path_length, data.assign_path(path_id, path_length));
         data.figure_ids[path_id] = id;
         routing_path_id = path_id;
         routing_path_length = path_length;
@@ -205,14 +340,19 @@ void figure::route_remove() {
     auto &data = g_figure_route_data;
     if (routing_path_id > 0) {
         if (data.figure_ids[routing_path_id] == id) {
-            data.figure_ids[routing_path_id] = 0;
+            data.release(routing_path_id);
         }
         routing_path_id = 0;
     }
 }
+
 int figure_route_get_direction(int path_id, int index) {
     auto &data = g_figure_route_data;
-    return data.direction_paths[path_id][index];
+    const auto &slot = data.slots[path_id];
+    if (index < 0 || index >= slot.length) {
+        return DIR_FIGURE_NONE;
+    }
+    return data.pool[slot.offset + index];
 }
 
 io_buffer* iob_route_figures = new io_buffer([](io_buffer* iob, size_t version) {
@@ -222,10 +362,33 @@ io_buffer* iob_route_figures = new io_buffer([](io_buffer* iob, size_t version)
     }
 });
 
+// saves keep the fixed MAX_ROUTES x MAX_PATH_LENGTH layout, the pool is only the in-memory form
 io_buffer* iob_route_paths = new io_buffer([](io_buffer* iob, size_t version) {
     auto &data = g_figure_route_data;
+    uint8_t row[MAX_PATH_LENGTH];
+    if (iob->is_read_access()) {
+        int figure_ids[MAX_ROUTES];
+        std::copy_n(data.figure_ids, MAX_ROUTES, figure_ids);
+        data.reset();
+        std::copy_n(figure_ids, MAX_ROUTES, data.figure_ids);
+        data.rebuild_free_ids();
+
+        for (int i = 0; i < MAX_ROUTES; i++) {
+            iob->bind(BIND_SIGNATURE_RAW, row, MAX_PATH_LENGTH);
+            if (i > 0 && data.figure_ids[i]) {
+                std::copy_n(row, MAX_PATH_LENGTH, data.assign_path(i, MAX_PATH_LENGTH));
+            }
+        }
+        return;
+    }
+
     for (int i = 0; i < MAX_ROUTES; i++) {
-        iob->bind(BIND_SIGNATURE_RAW, &data.direction_paths[i], MAX_PATH_LENGTH);
+        const auto &slot = data.slots[i];
+        std::fill_n(row, MAX_PATH_LENGTH, 0);
+        if (slot.length > 0) {
+            std::copy_n(&data.pool[slot.offset], slot.length, row);
+        }
+        iob->bind(BIND_SIGNATURE_RAW, row, MAX_PATH_LENGTH);
     }
 });
 
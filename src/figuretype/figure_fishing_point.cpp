@@ -50,7 +50,7 @@ void figure_fishing_point::figure_action() {
     case FIGURE_ACTION_197_FISHPOINT_JUMP:
         if (animation_finished) {
             advance_action(FIGURE_ACTION_196_FISHPOINT_BUBLES);
-            data.fishpoint.max_step = 5 + rand() % 10;
+            data.fishpoint.max_step = 5 + random_sim_between(0, 10);
         }
         break;
     }
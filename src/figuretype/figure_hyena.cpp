@@ -2,18 +2,18 @@
 
 #include "city/city.h"
 #include "figure/formation_layout.h"
+#include "grid/figure_index.h"
 
 figures::model_t<figure_hyena> hyena_m;
 
 int figure_combat_get_target_for_hyena(tile2i tile, int max_distance) {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (figure *f : map_figures()) {
-        if (!f->is_valid() || f->is_dead() || !f->type) {
-            continue;
+    // the nearest prey counts only when it is within max_distance, so the search can stop there
+    auto result = g_figure_index.nearest(tile, max_distance, FIGURE_INDEX_MASK_ALL, max_distance + 1, [&] (figure &f) {
+        if (!f.is_valid() || f.is_dead() || !f.type) {
+            return -1;
         }
 
-        switch (f->type) {
+        switch (f.type) {
         case FIGURE_EXPLOSION:
         case FIGURE_STANDARD_BEARER:
         case FIGURE_TRADE_SHIP:
@@ -29,30 +29,25 @@ int figure_combat_get_target_for_hyena(tile2i tile, int max_distance) {
         case FIGURE_BOLT:
         case FIGURE_BALLISTA:
         case FIGURE_CREATURE:
-            continue;
+            return -1;
 
         default:
             ; // nothing
         }
-        if (f->is_enemy() || f->is_herd()) {
-            continue;
+        if (f.is_enemy() || f.is_herd()) {
+            return -1;
         }
-        if (::smart_cast<figure_soldier>(f) && f->action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
-            continue;
+        if (::smart_cast<figure_soldier>(&f) && f.action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
+            return -1;
         }
-        int distance = calc_maximum_distance(tile, f->tile);
-        if (f->targeted_by_figure_id) {
+        int distance = calc_maximum_distance(tile, f.tile);
+        if (f.targeted_by_figure_id) {
             distance *= 2;
         }
-        if (distance < min_distance) {
-            min_distance = distance;
-            min_figure_id = f->id;
-        }
-    }
-    if (min_distance <= max_distance && min_figure_id) {
-        return min_figure_id;
-    }
-    return 0;
+        return distance;
+    });
+
+    return result.id;
 }
 
 void figure_hyena::on_create() {
@@ -9,6 +9,7 @@
 #include "graphics/image.h"
 #include "graphics/animation.h"
 #include "building/building_house.h"
+#include "core/random.h"
 
 figures::model_t<figure_priest> priest_m;
 figures::model_t<figure_festival_priest> festival_priest_m;
@@ -236,7 +237,7 @@ void figure_festival_priest::figure_action() {
 
     case FIGURE_ACTION_11_FESTIVAL_PRIEST_GOTO_SQUARE:
         if (do_goto(base.destination_tile, TERRAIN_USAGE_ANY, FIGURE_ACTION_12_FESTIVAL_PRIEST_DANCE)) {
-            base.wait_ticks = rand() % 20;
+            base.wait_ticks = random_sim_between(0, 20);
         }
         break;
 
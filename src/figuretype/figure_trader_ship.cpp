@@ -14,6 +14,7 @@
 #include "grid/figure.h"
 #include "city/city_figures.h"
 #include "dev/debug.h"
+#include "core/random.h"
 
 #include <iostream>
 
@@ -181,7 +182,7 @@ void figure_trade_ship::figure_action() {
         base.height_adjusted_ticks = 0;
         if (direction() == DIR_FIGURE_NONE) {
             base.action_state = FIGURE_ACTION_114_TRADE_SHIP_ANCHORED;
-            base.direction = rand() % 8;
+            base.direction = random_sim_between(0, 8);
         } else if (direction() == DIR_FIGURE_REROUTE) {
             route_remove();
         } else if (direction() == DIR_FIGURE_CAN_NOT_REACH) {
@@ -39,9 +39,9 @@
 #include "window/main_menu.h"
 #include "graphics/view/view.h"
 #include "platform/renderer.h"
+#include "platform/arguments.h"
 #include "io/movie_writer.h"
 #include "graphics/screen.h"
-#include "widget/widget_minimap.h"
 #include "city/city.h"
 #include "city/trade.h"
 #include "city/city_floods.h"
@@ -50,6 +50,7 @@
 #include "city/city_message.h"
 #include "building/industry.h"
 #include "io/gamestate/boilerplate.h"
+#include "io/manager.h"
 #include "scenario/distant_battle.h"
 #include "scenario/empire.h"
 #include "empire/empire.h"
@@ -126,17 +127,23 @@ void game_t::update_tick(int simtick) {
     game_undo_reduce_time_available();
 
     g_tutorials_flags.update_starting_message();
-    g_floods.tick_update(false);
+    tick_stats.measure(tick_stats.floods_mcs, [] { g_floods.tick_update(false); });
 
-    g_city.buildings.update_tick(game.paused);
+    tick_stats.measure(tick_stats.buildings_mcs, [] { g_city.buildings.update_tick(game.paused); });
 
-    g_city.update_tick(simtick);
-
-    if (simtime.advance_tick()) {
-        advance_day();
+    if (simtick >= 0 && simtick < tick_stats_t::MAX_SIMTICKS) {
+        tick_stats.measure(tick_stats.city_mcs[simtick], [simtick] { g_city.update_tick(simtick); });
+    } else {
+        g_city.update_tick(simtick);
     }
 
-    g_city.figures.update();
+    tick_stats.measure(tick_stats.advance_day_mcs, [this] {
+        if (simtime.advance_tick()) {
+            advance_day();
+        }
+    });
+
+    tick_stats.measure(tick_stats.figures_mcs, [] { g_city.figures.update(); });
 
     g_scenario.update();
     g_city.victory_check();
@@ -172,7 +179,7 @@ void game_t::advance_month() {
 
     map_tiles_update_all_roads();
     //    map_tiles_river_refresh_entire();
-    map_routing_update_land_citizen();
+    map_routing_update_land();
     //    city_message_sort_and_compact();
 
     if (simtime.advance_month()) {
@@ -191,7 +198,8 @@ void game_t::advance_month() {
 
     if (g_settings.monthly_autosave) {
         bstring256 autosave_file("autosave_month.", saved_game_data_expanded.extension);
-        GamestateIO::write_savegame(autosave_file);
+        OZZY_PROFILER_SECTION("Game/Autosave");
+        GamestateIO::write_savegame_async(autosave_file);
     }
 
     events::emit(event_advance_month::from_simtime(game.simtime));
@@ -208,7 +216,6 @@ void game_t::advance_day() {
     g_city.update_day();
 
     g_sound.music_update(false);
-    widget_minimap_invalidate();
 
     events::emit(event_advance_day::from_simtime(game.simtime));
 }
@@ -544,8 +551,13 @@ void game_t::handle_input_frame() {
 }
 
 void game_t::exit() {
+    // the last autosave may still be compressing on game.mt
+    FILEIO.wait_async_write();
     video_shutdown();
-    g_settings.save();
-    game_features::save();
+    // a headless run overrides autosave and window settings, they must not reach the user config
+    if (!g_args.is_headless()) {
+        g_settings.save();
+        game_features::save();
+    }
     g_sound.shutdown();
 }
@@ -39,6 +39,35 @@ enum e_session_type {
 
 class MovieWriter;
 
+// per subsystem time spent in game_t::update_tick, filled only while enabled (headless runs)
+struct tick_stats_t {
+    enum {
+        MAX_SIMTICKS = simulation_time_t::ticks_in_day,
+    };
+
+    bool enabled = false;
+    uint64_t city_mcs[MAX_SIMTICKS] = {};
+    uint64_t floods_mcs = 0;
+    uint64_t buildings_mcs = 0;
+    uint64_t figures_mcs = 0;
+    uint64_t advance_day_mcs = 0;
+
+    void reset() { *this = tick_stats_t(); }
+
+    template<typename F>
+    inline void measure(uint64_t &mcs, F func) {
+        if (!enabled) {
+            func();
+            return;
+        }
+
+        timer section_timer;
+        section_timer.start();
+        func();
+        mcs += section_timer.get_elapsed_mcs();
+    }
+};
+
 struct game_t {
     enum {
         MAX_ANIM_TIMERS = 51
@@ -57,6 +86,7 @@ struct game_t {
 
     MovieWriter *mvwriter = nullptr;
     simulation_time_t simtime;
+    tick_stats_t tick_stats;
 
     struct {
         xstring last_loaded_mission;
@@ -0,0 +1,158 @@
+#include "headless.h"
+
+#include "core/log.h"
+#include "core/system_time.h"
+#include "game/game.h"
+#include "game/game_events.h"
+#include "game/settings.h"
+#include "game/state_hash.h"
+#include "content/vfs.h"
+#include "io/gamestate/boilerplate.h"
+
+#include <cinttypes>
+#include <cstdlib>
+
+static void headless_report(int ticks, uint64_t elapsed_mcs) {
+    const auto &stats = game.tick_stats;
+    const double seconds = elapsed_mcs / 1000000.0;
+    logs::info("headless: %d ticks in %.3f s, %.1f ticks/s", ticks, seconds, seconds > 0 ? ticks / seconds : 0.0);
+
+    auto report_line = [ticks] (pcstr name, uint64_t mcs) {
+        if (!mcs) {
+            return;
+        }
+        logs::info("headless: %-16s %10llu us total, %8.2f us/tick", name, (unsigned long long)mcs, double(mcs) / ticks);
+    };
+
+    report_line("floods", stats.floods_mcs);
+    report_line("buildings", stats.buildings_mcs);
+    report_line("advance day", stats.advance_day_mcs);
+    report_line("figures", stats.figures_mcs);
+    for (int simtick = 0; simtick < tick_stats_t::MAX_SIMTICKS; ++simtick) {
+        bstring32 name("city tick ", simtick);
+        report_line(name, stats.city_mcs[simtick]);
+    }
+}
+
+// one line per tick: "<tick> <part0> <part1> ..." with the digest parts in hex
+struct headless_digest_log_t {
+    FILE *record = nullptr;
+    FILE *compare = nullptr;
+
+    bool open(pcstr record_file, pcstr compare_file) {
+        if (*record_file) {
+            record = vfs::file_open_os(record_file, "wt");
+            if (!record) {
+                logs::error("headless: unable to write digests to %s", record_file);
+                return false;
+            }
+        }
+
+        if (*compare_file) {
+            compare = vfs::file_open_os(compare_file, "rt");
+            if (!compare) {
+                logs::error("headless: unable to read digests from %s", compare_file);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void close() {
+        if (record) {
+            vfs::file_close(record);
+        }
+        if (compare) {
+            vfs::file_close(compare);
+        }
+        record = compare = nullptr;
+    }
+
+    bool active() const { return record || compare; }
+
+    // false when the state differs from the recorded one or the record ran out
+    bool step(int tick) {
+        const state_digest_t digest = game_state_digest();
+        if (record) {
+            fprintf(record, "%d", tick);
+            for (uint32_t part : digest.parts) {
+                fprintf(record, " %08" PRIx32, part);
+            }
+            fprintf(record, "\n");
+        }
+
+        if (!compare) {
+            return true;
+        }
+
+        int recorded_tick = -1;
+        state_digest_t expected;
+        bool ok = fscanf(compare, "%d", &recorded_tick) == 1;
+        for (uint32_t &part : expected.parts) {
+            ok = ok && fscanf(compare, "%" SCNx32, &part) == 1;
+        }
+
+        if (!ok || recorded_tick != tick) {
+            logs::error("headless: digest record has no entry for tick %d", tick);
+            return false;
+        }
+
+        const int part = digest.first_mismatch(expected);
+        if (part >= 0) {
+            logs::error("headless: state diverged at tick %d in %s (%08x, recorded %08x)", tick, game_state_part_name(part), digest.parts[part], expected.parts[part]);
+            return false;
+        }
+        return true;
+    }
+};
+
+int game_headless_run(pcstr savefile, int ticks, pcstr record_file, pcstr compare_file) {
+    logs::info("headless: loading %s", savefile);
+
+    // autosaves would write into the user saves folder and add disk time to the measurement,
+    // game_t::exit() does not save settings after a headless run
+    g_settings.monthly_autosave = false;
+    if (!GamestateIO::load_savegame(savefile)) {
+        logs::error("headless: unable to load savegame %s", savefile);
+        return EXIT_FAILURE;
+    }
+    events::process();
+
+    headless_digest_log_t digests;
+    if (!digests.open(record_file, compare_file)) {
+        digests.close();
+        return EXIT_FAILURE;
+    }
+
+    // tick 0 is the state right after loading
+    bool in_sync = !digests.active() || digests.step(0);
+
+    game.paused = false;
+    game.tick_stats.reset();
+    game.tick_stats.enabled = true;
+
+    // only the ticks are timed, digests walk the whole state and would dominate ticks/s
+    timer tick_timer;
+    uint64_t elapsed_ticks = 0;
+    int done = 0;
+    for (; done < ticks && in_sync; ++done) {
+        tick_timer.start();
+        game.update_tick(game.simtime.tick);
+        events::process();
+        elapsed_ticks += tick_timer.get_elapsed_ticks();
+
+        if (digests.active()) {
+            in_sync = digests.step(done + 1);
+        }
+    }
+    const uint64_t elapsed_mcs = elapsed_ticks * uint64_t(1000000) / platform.qpc_per_second;
+    digests.close();
+
+    game.tick_stats.enabled = false;
+    headless_report(done, elapsed_mcs);
+    if (*compare_file && in_sync) {
+        logs::info("headless: %d ticks match %s", done, compare_file);
+    }
+
+    return in_sync ? EXIT_SUCCESS : EXIT_FAILURE;
+}
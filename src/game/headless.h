@@ -0,0 +1,9 @@
+#pragma once
+
+#include "core/bstring.h"
+
+// loads a savegame and runs the simulation for the given number of ticks as fast as possible,
+// nothing is drawn and the timing report goes to the log.
+// record_file gets the state digest of every tick, compare_file is checked against them
+// and the run stops at the first tick whose state differs; both may be empty
+int game_headless_run(pcstr savefile, int ticks, pcstr record_file = "", pcstr compare_file = "");
@@ -0,0 +1,74 @@
+#include "state_hash.h"
+
+#include "core/buffer.h"
+#include "core/crc32.h"
+#include "core/profiler.h"
+#include "io/gamestate/boilerplate.h"
+
+#include <string.h>
+
+static const char *g_state_part_names[STATE_PART_COUNT] = {"grids", "buildings", "figures", "city", "random", "other"};
+
+// chunks that only describe the view of the player, they change without the simulation moving
+static bool state_chunk_ignored(pcstr name) {
+    return strstr(name, "city_view") != nullptr || strcmp(name, "bookmarks") == 0;
+}
+
+static e_state_part state_chunk_part(pcstr name) {
+    if (strcmp(name, "random_iv") == 0) {
+        return STATE_PART_RANDOM;
+    }
+
+    if (strstr(name, "grid") || strstr(name, "GRID") || strcmp(name, "vegetation_growth") == 0) {
+        return STATE_PART_GRIDS;
+    }
+
+    if (strncmp(name, "building", 8) == 0) {
+        return STATE_PART_BUILDINGS;
+    }
+
+    if (strncmp(name, "figure", 6) == 0 || strncmp(name, "route_", 6) == 0 || strncmp(name, "formations", 10) == 0) {
+        return STATE_PART_FIGURES;
+    }
+
+    if (strncmp(name, "city_", 5) == 0 || strcmp(name, "game_time") == 0) {
+        return STATE_PART_CITY;
+    }
+
+    return STATE_PART_OTHER;
+}
+
+bool state_digest_t::operator==(const state_digest_t &other) const {
+    return first_mismatch(other) < 0;
+}
+
+int state_digest_t::first_mismatch(const state_digest_t &other) const {
+    for (int i = 0; i < STATE_PART_COUNT; ++i) {
+        if (parts[i] != other.parts[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+state_digest_t game_state_digest() {
+    OZZY_PROFILER_SECTION("Game/StateDigest");
+    state_digest_t digest;
+    GamestateIO::bind_savegame_state([&digest] (pcstr name, const buffer &buf) {
+        if (state_chunk_ignored(name)) {
+            return;
+        }
+
+        uint32_t &part = digest.parts[state_chunk_part(name)];
+        const uint32_t crc = crc32(buf.get_data(), (uint32_t)buf.size());
+        part = (part ^ crc) * 16777619u;
+    });
+    return digest;
+}
+
+pcstr game_state_part_name(int part) {
+    if (part < 0 || part >= STATE_PART_COUNT) {
+        return "unknown";
+    }
+    return g_state_part_names[part];
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/bstring.h"
+
+#include <cstdint>
+
+enum e_state_part {
+    STATE_PART_GRIDS,
+    STATE_PART_BUILDINGS,
+    STATE_PART_FIGURES,
+    STATE_PART_CITY,
+    STATE_PART_RANDOM,
+    STATE_PART_OTHER,
+    STATE_PART_COUNT
+};
+
+// digest of the simulation state, split by subsystem so a divergence can be pinned down.
+// built from the savegame chunks, so whatever the savegame keeps is covered
+struct state_digest_t {
+    uint32_t parts[STATE_PART_COUNT] = {0};
+
+    bool operator==(const state_digest_t &other) const;
+    bool operator!=(const state_digest_t &other) const { return !(*this == other); }
+    int first_mismatch(const state_digest_t &other) const; // -1 when equal
+};
+
+state_digest_t game_state_digest();
+pcstr game_state_part_name(int part);
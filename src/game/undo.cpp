@@ -6,6 +6,7 @@
 #include "city/finance.h"
 #include "game/game_events.h"
 #include "city/city_resource.h"
+#include "city/city.h"
 #include "city/city_buildings.h"
 #include "game/resource.h"
 #include "graphics/image.h"
@@ -139,17 +140,10 @@ void game_undo_restore_building_state(void) {
 }
 
 static void restore_map_images(void) {
-    int map_width = scenario_map_data()->width;
-    int map_height = scenario_map_data()->height;
-    //    int map_width, map_height;
-    //    map_grid_size(&map_width, &map_height);
-    for (int y = 0; y < map_height; y++) {
-        for (int x = 0; x < map_width; x++) {
-            int grid_offset = MAP_OFFSET(x, y);
-            if (!map_building_at(grid_offset))
-                map_image_restore_at(grid_offset);
-        }
-    }
+    // only tiles touched since the build started are in the journal
+    map_image_restore_if([] (int grid_offset) {
+        return !map_building_at(grid_offset);
+    });
 }
 
 void game_undo_restore_map(int include_properties) {
@@ -174,6 +168,7 @@ static void add_building_to_terrain(building* b) {
     int size = building_impl::params(b->type).building_size;
     map_building_tiles_add(b->id, b->tile, size, 0, 0);
     b->state = BUILDING_STATE_VALID;
+    g_city.buildings.add_live_building(*b);
 
     auto main = b->main();
     main->dcast()->on_undo();
@@ -70,8 +70,13 @@ int lang_text_draw(int group, int number, int x_offset, int y_offset, e_font fon
 }
 
 int lang_text_draw(pcstr str, vec2i pos, e_font font, int box_width) {
-    if (box_width > 0) {
-        uint32_t maxlen = text_get_max_length_for_width((const uint8_t*)str, strlen((pcstr)str), font, box_width, false);
+    if (box_width > 0 && str) {
+        const uint32_t length = strlen(str);
+        uint32_t maxlen = text_get_max_length_for_width((const uint8_t*)str, length, font, box_width, false);
+        if (maxlen >= length) {
+            return text_draw((const uint8_t*)str, pos.x, pos.y, font, 0);
+        }
+
         bstring1024 temp_str;
         temp_str.ncat((pcstr)str, maxlen);
         return text_draw((const uint8_t*)temp_str.c_str(), pos.x, pos.y, font, 0);
@@ -8,6 +8,7 @@
 #include "graphics/elements/scrollbar.h"
 #include "graphics/elements/panel.h"
 #include "graphics/image.h"
+#include "graphics/text.h"
 #include "graphics/image_groups.h"
 #include "graphics/window.h"
 #include "game/game.h"
@@ -121,7 +122,6 @@ static int get_lexem_width(const uint8_t *str, int in_link) {
     int width = 0;
     int guard = 0;
     int word_char_seen = 0;
-    int num_bytes = 1;
     while (*str && ++guard < 2000) {
         if (*str == ' ') {
             if (word_char_seen) {
@@ -131,9 +131,9 @@ static int get_lexem_width(const uint8_t *str, int in_link) {
             width += 4;
         } else if (*str > ' ') {
             // normal char
-            int letter_id = font_letter_id(normal_font_def, str, &num_bytes);
-            if (letter_id >= 0) {
-                width += normal_font_def->letter_spacing + image_letter(letter_id)->width;
+            const font_glyph_t glyph = text_glyph(normal_font_def, str);
+            if (glyph.valid) {
+                width += normal_font_def->letter_spacing + glyph.width;
             }
         }
         str++;
@@ -188,9 +188,10 @@ static int get_word_width(const uint8_t* str, int in_link, int* num_chars) {
             width += 4;
         } else if (*str > ' ') {
             // normal char
-            int letter_id = font_letter_id(normal_font_def, str, &num_bytes);
-            if (letter_id >= 0)
-                width += 1 + image_letter(letter_id)->width;
+            const font_glyph_t glyph = text_glyph(normal_font_def, str);
+            num_bytes = glyph.num_bytes;
+            if (glyph.valid)
+                width += 1 + glyph.width;
 
             word_char_seen = 1;
             if (num_bytes > 1) {
@@ -260,9 +261,9 @@ static void draw_line(painter &ctx, const uint8_t* str, int x, int y, color clr,
                 def = link_font_def;
             }
 
-            int num_bytes = 1;
-            int letter_id = font_letter_id(def, str, &num_bytes);
-            if (letter_id < 0) {
+            const font_glyph_t glyph = text_glyph(def, str);
+            const int num_bytes = glyph.num_bytes;
+            if (glyph.letter_id < 0) {
                 x += def->space_width;
             } else {
                 if (num_bytes > 1 && start_link) {
@@ -271,12 +272,10 @@ static void draw_line(painter &ctx, const uint8_t* str, int x, int y, color clr,
                     start_link = 0;
                 }
 
-                const image_t* img = image_letter(letter_id);
-                if (!measure_only) {
-                    int height = def->image_y_offset(*str, img->height, def->line_height);
-                    ImageDraw::img_letter(ctx, def->font, letter_id, x, y - height, clr);
+                if (!measure_only && glyph.valid) {
+                    ImageDraw::img_letter(ctx, def->font, glyph.letter_id, x, y - glyph.y_offset, clr);
                 }
-                x += img->width + def->letter_spacing;
+                x += glyph.width + def->letter_spacing;
             }
 
             if (num_link_chars > 0) {
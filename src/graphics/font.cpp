@@ -150,6 +150,7 @@ struct font_data_t {
     const int* font_mapping;
     const font_definition* font_definitions;
     int multibyte;
+    uint32_t generation = 1;
 };
 
 static font_data_t g_font_data;
@@ -361,6 +362,15 @@ void font_set_encoding(encoding_type encoding) {
         data.font_mapping = CHAR_TO_FONT_IMAGE_DEFAULT;
         data.font_definitions = DEFINITIONS_DEFAULT;
     }
+    font_invalidate_glyphs();
+}
+
+void font_invalidate_glyphs() {
+    g_font_data.generation++;
+}
+
+uint32_t font_generation() {
+    return g_font_data.generation;
 }
 
 const font_definition* font_definition_for(e_font font) {
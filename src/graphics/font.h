@@ -55,6 +55,18 @@ enum {
  */
 void font_set_encoding(encoding_type encoding);
 
+/**
+ * Drops everything derived from the current glyph images and mapping,
+ * call it when the encoding or the font images change
+ */
+void font_invalidate_glyphs();
+
+/**
+ * Gets the glyph generation, bumped by font_invalidate_glyphs()
+ * @return Generation counter, caches built with another value are stale
+ */
+uint32_t font_generation();
+
 /**
  * Gets the font definition for the specified font
  * @param font Font
@@ -6,6 +6,8 @@
 #include "graphics/imagepak_holder.h"
 #include "content/dir.h"
 #include "core/svector.h"
+#include "core/system_time.h"
+#include "core/log.h"
 
 #include <array>
 
@@ -38,6 +40,7 @@ bool image_set_font_pak(encoding_type encoding) {
         //        data.font = 0;
         //        data.font_data = 0;
         data.fonts_enabled = NO_EXTRA_FONT;
+        font_invalidate_glyphs();
         return true;
     }
 }
@@ -56,6 +59,9 @@ bool image_load_paks() {
     data.fonts_loaded = false;
     data.font_base_offset = 0;
 
+    timer load_timer;
+    load_timer.start();
+
     data.pak_list[PACK_FONT].handle = new imagepak("Pharaoh_Fonts", 18765, false, true);
     data.fonts_loaded = true;
 
@@ -86,6 +92,19 @@ bool image_load_paks() {
         data.pak_list[useridx].custom = true;
     }
 
+    imagepak::load_stats_t total;
+    for (const auto &imgpak : data.pak_list) {
+        if (!imgpak.handle) {
+            continue;
+        }
+        total.read_ms += imgpak.handle->load_stats.read_ms;
+        total.decode_ms += imgpak.handle->load_stats.decode_ms;
+        total.upload_ms += imgpak.handle->load_stats.upload_ms;
+    }
+    logs::info("Imagepaks loaded in %u ms: read %u ms, decode %u ms, upload %u ms",
+               load_timer.get_elapsed_ms(), total.read_ms, total.decode_ms, total.upload_ms);
+
+    font_invalidate_glyphs();
     return true;
 }
 
@@ -3,6 +3,7 @@
 #include "game/game.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
+#include "graphics/sprite_batch.h"
 #include "platform/renderer.h"
 
 #include <string>
@@ -39,17 +40,6 @@ void painter::draw_impl(SDL_Texture *texture, vec2i pos, vec2i offset, vec2i siz
         DOWNSCALED_CITY = true;
     }
 
-    graphics_renderer()->set_texture_scale_mode(texture, overall_scale_factor, force_linear);
-
-    SDL_SetTextureColorMod(texture,
-                           (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
-                           (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
-                           (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE);
-    SDL_SetTextureAlphaMod(texture, (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
-
-    const bool alpha = !!(flags & ImgFlag_Alpha);
-    SDL_SetTextureBlendMode(texture, alpha ? SDL_BLENDMODE_BLEND : (SDL_BlendMode)graphics_renderer()->premult_alpha());
-
     // uncomment here if you want save something from atlases
     int k = 0;
     if (k == 1) {
@@ -80,6 +70,23 @@ void painter::draw_impl(SDL_Texture *texture, vec2i pos, vec2i offset, vec2i siz
                          size.y * y_scale_factor};
     }
 
+    const bool alpha = !!(flags & ImgFlag_Alpha);
+    const SDL_BlendMode blend = alpha ? SDL_BLENDMODE_BLEND : (SDL_BlendMode)graphics_renderer()->premult_alpha();
+    if (g_sprite_batch.active()) {
+        g_sprite_batch.draw(this->renderer, texture, blend, overall_scale_factor, force_linear,
+                            texture_coords, screen_coords, color, angle, !!(flags & ImgFlag_Mirrored));
+        return;
+    }
+
+    graphics_renderer()->set_texture_scale_mode(texture, overall_scale_factor, force_linear);
+
+    SDL_SetTextureColorMod(texture,
+                           (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
+                           (color & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN,
+                           (color & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE);
+    SDL_SetTextureAlphaMod(texture, (color & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA);
+    SDL_SetTextureBlendMode(texture, blend);
+
     if (!!(flags & ImgFlag_Mirrored)) {
         SDL_RenderCopyExF(this->renderer, texture, &texture_coords, &screen_coords, angle, nullptr, SDL_FLIP_HORIZONTAL);
     } else {
@@ -128,6 +135,7 @@ SDL_Texture* painter::convertToGrayscale(SDL_Texture *tx, vec2i offset, vec2i si
      * Initialize our canvas, then copy texture to a target whose pixel data we
      * can access
      */
+    g_sprite_batch.flush();
     SDL_Texture *old_target = SDL_GetRenderTarget(this->renderer);
     st = SDL_SetRenderTarget(this->renderer, ren_tex);
     if (st != 0) {
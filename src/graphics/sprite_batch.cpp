@@ -0,0 +1,125 @@
+#include "sprite_batch.h"
+
+#include "platform/platform.h"
+#include "platform/renderer.h"
+#include "dev/debug.h"
+
+#include <algorithm>
+#include <cmath>
+
+sprite_batch_t g_sprite_batch;
+
+declare_console_command_p(spritebatch) {
+    std::string args; is >> args;
+
+    auto &batch = g_sprite_batch;
+    if (args == "on") {
+        batch.enabled = true;
+    } else if (args == "off") {
+        batch.flush();
+        batch.enabled = false;
+    }
+
+    os << "sprite batch: " << (batch.active() ? "on" : "off")
+       << ", last frame " << batch.last_frame.quads << " sprites in " << batch.last_frame.flushes << " draws" << std::endl;
+}
+
+bool sprite_batch_t::active() const {
+#ifdef USE_RENDER_GEOMETRY
+    static const bool has_geometry = platform_sdl_version_at_least(2, 0, 18);
+    return enabled && has_geometry;
+#else
+    return false;
+#endif
+}
+
+void sprite_batch_t::draw(SDL_Renderer *r, SDL_Texture *tx, SDL_BlendMode b, float scale, bool linear_forced,
+                          const SDL_Rect &src, const SDL_FRect &dst, color c, double angle, bool mirrored) {
+#ifdef USE_RENDER_GEOMETRY
+    // same choice as graphics_renderer_interface::set_texture_scale_mode
+    const bool want_linear = linear_forced || scale < 1.0f;
+    if (tx != texture || r != renderer || b != blend || want_linear != linear) {
+        flush();
+        renderer = r;
+        texture = tx;
+        blend = b;
+        scale_factor = scale;
+        force_linear = linear_forced;
+        linear = want_linear;
+        SDL_QueryTexture(tx, nullptr, nullptr, &texture_size.x, &texture_size.y);
+    }
+
+    if (texture_size.x <= 0 || texture_size.y <= 0) {
+        return;
+    }
+
+    float u0 = (float)src.x / texture_size.x;
+    float u1 = (float)(src.x + src.w) / texture_size.x;
+    const float v0 = (float)src.y / texture_size.y;
+    const float v1 = (float)(src.y + src.h) / texture_size.y;
+    if (mirrored) {
+        std::swap(u0, u1);
+    }
+
+    const SDL_Color vc = {(Uint8)((c & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED),
+                          (Uint8)((c & COLOR_CHANNEL_GREEN) >> COLOR_BITSHIFT_GREEN),
+                          (Uint8)((c & COLOR_CHANNEL_BLUE) >> COLOR_BITSHIFT_BLUE),
+                          (Uint8)((c & COLOR_CHANNEL_ALPHA) >> COLOR_BITSHIFT_ALPHA)};
+
+    SDL_FPoint corners[4] = {{dst.x, dst.y}, {dst.x + dst.w, dst.y}, {dst.x + dst.w, dst.y + dst.h}, {dst.x, dst.y + dst.h}};
+    if (angle != 0) {
+        // SDL_RenderCopyExF turns clockwise around the center of dst
+        const double rad = angle * 3.14159265358979323846 / 180.0;
+        const float s = (float)std::sin(rad);
+        const float co = (float)std::cos(rad);
+        const float cx = dst.x + dst.w * 0.5f;
+        const float cy = dst.y + dst.h * 0.5f;
+        for (auto &p : corners) {
+            const float dx = p.x - cx;
+            const float dy = p.y - cy;
+            p = {cx + dx * co - dy * s, cy + dx * s + dy * co};
+        }
+    }
+
+    const int first = (int)vertices.size();
+    vertices.push_back({corners[0], vc, {u0, v0}});
+    vertices.push_back({corners[1], vc, {u1, v0}});
+    vertices.push_back({corners[2], vc, {u1, v1}});
+    vertices.push_back({corners[3], vc, {u0, v1}});
+
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+    for (int i : quad) {
+        indices.push_back(first + i);
+    }
+    ++frame.quads;
+#endif
+}
+
+void sprite_batch_t::flush() {
+#ifdef USE_RENDER_GEOMETRY
+    // the next draw queries the texture again, a destroyed atlas page
+    // can come back at the same address with another size
+    SDL_Texture *tx = texture;
+    texture = nullptr;
+    if (indices.empty()) {
+        return;
+    }
+
+    // texture state is read when the geometry is drawn, vertex colors carry the color mod
+    graphics_renderer()->set_texture_scale_mode(tx, scale_factor, force_linear);
+    SDL_SetTextureColorMod(tx, 0xff, 0xff, 0xff);
+    SDL_SetTextureAlphaMod(tx, 0xff);
+    SDL_SetTextureBlendMode(tx, blend);
+    SDL_RenderGeometry(renderer, tx, vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+    ++frame.flushes;
+
+    vertices.clear();
+    indices.clear();
+#endif
+}
+
+void sprite_batch_t::end_frame() {
+    flush();
+    last_frame = frame;
+    frame = {};
+}
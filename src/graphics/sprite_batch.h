@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/vec2i.h"
+#include "graphics/color.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <SDL.h>
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define USE_RENDER_GEOMETRY
+#endif
+
+// textured quads from painter::draw_impl collected while they share the atlas texture, blend
+// and scale mode, then drawn with one SDL_RenderGeometry call. every other renderer call flushes
+// first, so the draw order stays the same as with one SDL_RenderCopyExF per sprite
+struct sprite_batch_t {
+    struct stats_t {
+        uint32_t quads = 0;
+        uint32_t flushes = 0;
+    };
+
+    bool enabled = true;
+    stats_t frame;      // counted since the last end_frame()
+    stats_t last_frame;
+
+    bool active() const;
+
+    // coordinates are the same src/dst rects SDL_RenderCopyExF takes, color is the color/alpha mod
+    void draw(SDL_Renderer *renderer, SDL_Texture *texture, SDL_BlendMode blend, float scale_factor, bool force_linear,
+              const SDL_Rect &src, const SDL_FRect &dst, color color, double angle, bool mirrored);
+    void flush();
+    void end_frame();
+
+private:
+    SDL_Renderer *renderer = nullptr;
+    SDL_Texture *texture = nullptr;
+    SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+    float scale_factor = 1.f;
+    bool force_linear = false;
+    bool linear = false;
+    vec2i texture_size;
+
+#ifdef USE_RENDER_GEOMETRY
+    std::vector<SDL_Vertex> vertices;
+#endif
+    std::vector<int> indices;
+};
+
+extern sprite_batch_t g_sprite_batch;
@@ -6,12 +6,57 @@
 #include "graphics/view/view.h"
 #include "io/gamefiles/lang.h"
 #include "game/game.h"
+#include "core/crc32.h"
+#include "dev/debug.h"
+
+#include <algorithm>
+#include <unordered_map>
 
 #define ELLIPSIS_LENGTH 4
 #define NUMBER_BUFFER_LENGTH 100
+#define TEXT_LAYOUT_CACHE_MAX 2048
 
 static uint8_t tmp_line[200];
 
+struct font_glyph_table_t {
+    uint32_t generation = 0;
+    font_glyph_t glyphs[256];
+};
+
+font_glyph_table_t g_font_glyphs[FONT_TYPES_MAX];
+
+struct text_layout_cache_t {
+    struct entry_t {
+        std::vector<uint8_t> text;
+        uint32_t generation;
+        uint32_t stamp;
+        text_layout_t layout;
+    };
+
+    std::unordered_map<uint32_t, entry_t> entries;
+    uint32_t clock = 0;
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    bool enabled = true;
+};
+
+text_layout_cache_t g_text_layout_cache;
+
+declare_console_command_p(textcache) {
+    std::string args; is >> args;
+
+    auto &cache = g_text_layout_cache;
+    if (args == "on") {
+        cache.enabled = true;
+    } else if (args == "off") {
+        cache.enabled = false;
+        cache.entries.clear();
+    }
+
+    os << "text layout cache: " << (cache.enabled ? "on" : "off")
+       << ", entries " << cache.entries.size() << ", hits " << cache.hits << ", misses " << cache.misses << std::endl;
+}
+
 struct input_cursor_t {
     int capture;
     int seen;
@@ -89,44 +134,79 @@ int get_letter_height(const uint8_t* str, e_font font) {
     return letter_id >= 0 ? image_letter(letter_id)->height : 0;
 }
 
-int text_get_width(const uint8_t* str, e_font font) {
-    if (!str) {
-        return 0;
+static font_glyph_t text_glyph_lookup(const font_definition *def, const uint8_t *str) {
+    font_glyph_t glyph = {-1, 0, 0, 0, 1, 0};
+    int num_bytes = 1;
+    glyph.letter_id = font_letter_id(def, str, &num_bytes);
+    glyph.num_bytes = num_bytes;
+    if (glyph.letter_id >= 0) {
+        const image_t *img = image_letter(glyph.letter_id);
+        if (img != nullptr) {
+            glyph.valid = 1;
+            glyph.width = img->width;
+            glyph.height = img->height;
+            glyph.y_offset = def->image_y_offset(*str, img->height, def->line_height);
+        }
     }
+    return glyph;
+}
 
-    const font_definition* def = font_definition_for(font);
+font_glyph_t text_glyph(const font_definition *def, const uint8_t *str) {
+    auto &table = g_font_glyphs[def->font];
+    const uint32_t generation = font_generation();
+    if (table.generation != generation) {
+        for (int c = 0; c < 256; ++c) {
+            const uint8_t ch[2] = {(uint8_t)c, 0};
+            table.glyphs[c] = text_glyph_lookup(def, ch);
+        }
+        table.generation = generation;
+    }
+
+    const font_glyph_t &glyph = table.glyphs[*str];
+    if (glyph.num_bytes == 1) {
+        return glyph;
+    }
+
+    // multibyte letters depend on the second byte
+    return text_glyph_lookup(def, str);
+}
+
+static int text_get_width_direct(const uint8_t *str, const font_definition *def) {
     int maxlen = 10000;
     int width = 0;
     while (*str && maxlen > 0) {
-        int num_bytes = 1;
-        if (*str == ' ')
+        const font_glyph_t glyph = text_glyph(def, str);
+        if (*str == ' ') {
             width += def->space_width;
-        else {
-            int letter_id = font_letter_id(def, str, &num_bytes);
-            if (letter_id >= 0) {
-                const image_t* img = image_letter(letter_id);
-                if (img != nullptr)
-                    width += def->letter_spacing + img->width;
-            }
+        } else if (glyph.valid) {
+            width += def->letter_spacing + glyph.width;
         }
-        str += num_bytes;
-        maxlen -= num_bytes;
+        str += glyph.num_bytes;
+        maxlen -= glyph.num_bytes;
     }
     return width;
 }
 
+int text_get_width(const uint8_t* str, e_font font) {
+    if (!str) {
+        return 0;
+    }
+
+    if (g_text_layout_cache.enabled) {
+        return text_layout_get(str, font).width;
+    }
+
+    return text_get_width_direct(str, font_definition_for(font));
+}
+
 int get_letter_width(const uint8_t* str, const font_definition* def, int* num_bytes) {
-    *num_bytes = 1;
+    const font_glyph_t glyph = text_glyph(def, str);
+    *num_bytes = (*str == ' ') ? 1 : glyph.num_bytes;
     if (*str == ' ') {
         return def->space_width;
     }
 
-    int letter_id = font_letter_id(def, str, num_bytes);
-    if (letter_id >= 0) {
-        return def->letter_spacing + image_letter(letter_id)->width;
-    } else {
-        return 0;
-    }
+    return glyph.valid ? def->letter_spacing + glyph.width : 0;
 }
 
 static int get_word_width(const uint8_t* str, e_font font, int* out_num_chars) {
@@ -148,9 +228,10 @@ static int get_word_width(const uint8_t* str, e_font font, int* out_num_chars) {
 
         } else if (*str > ' ') {
             // normal char
-            int letter_id = font_letter_id(def, str, &num_bytes);
-            if (letter_id >= 0)
-                width += image_letter(letter_id)->width + def->letter_spacing;
+            const font_glyph_t glyph = text_glyph(def, str);
+            num_bytes = glyph.num_bytes;
+            if (glyph.valid)
+                width += glyph.width + def->letter_spacing;
 
             word_char_seen = 1;
             if (num_bytes > 1) {
@@ -164,10 +245,188 @@ static int get_word_width(const uint8_t* str, e_font font, int* out_num_chars) {
     *out_num_chars = num_chars;
     return width;
 }
+// glyphs of one line the way text_draw() walks it, unknown letters are drawn as '?'
+static void text_layout_append(text_layout_t &layout, const font_definition *def, const uint8_t *str, int length) {
+    text_layout_t::line_t line = {(uint32_t)layout.glyphs.size(), 0};
+    while (length > 0) {
+        const font_glyph_t glyph = text_glyph(def, str);
+        text_layout_t::glyph_t out = {-1, 0, 0, 0, glyph.num_bytes};
+        out.measure = (*str == ' ') ? def->space_width : (glyph.valid ? def->letter_spacing + glyph.width : 0);
+
+        if (*str >= ' ') {
+            font_glyph_t letter = glyph;
+            if (letter.letter_id < 0) {
+                letter = text_glyph(def, (const uint8_t *)"?");
+                letter.y_offset = letter.valid ? def->image_y_offset(*str, letter.height, def->line_height) : 0;
+                out.num_bytes = 1;
+            }
+
+            if (*str == ' ' || *str == '_') {
+                out.advance = def->space_width;
+            } else if (letter.valid) {
+                out.letter_id = letter.letter_id;
+                out.y_offset = letter.y_offset;
+                out.advance = def->letter_spacing + letter.width;
+            }
+        } else {
+            out.num_bytes = 1;
+        }
+
+        layout.glyphs.push_back(out);
+        str += out.num_bytes;
+        length -= out.num_bytes;
+    }
+    line.count = (uint32_t)layout.glyphs.size() - line.first;
+    layout.lines.push_back(line);
+}
+
+// same word wrapping text_draw_multiline() always had, leading whitespace of a line is dropped
+static void text_layout_wrap(text_layout_t &layout, const font_definition *def, const uint8_t *str) {
+    uint8_t line[200];
+    int has_more_characters = 1;
+    int guard = 0;
+    while (has_more_characters) {
+        if (++guard >= 100)
+            break;
+
+        int current_width = 0;
+        int line_index = 0;
+        while (has_more_characters && current_width < layout.box_width) {
+            int word_num_chars;
+            int word_width = get_word_width(str, layout.font, &word_num_chars);
+            current_width += word_width;
+            if (current_width >= layout.box_width) {
+                if (current_width == 0)
+                    has_more_characters = 0;
+
+            } else {
+                for (int i = 0; i < word_num_chars; i++) {
+                    if ((line_index == 0 && *str <= ' ') || line_index >= (int)sizeof(line))
+                        str++;
+                    else {
+                        line[line_index++] = *str++;
+                    }
+                }
+                if (!*str)
+                    has_more_characters = 0;
+                else if (*str == '\n') {
+                    str++;
+                    break;
+                }
+            }
+        }
+        text_layout_append(layout, def, line, line_index);
+    }
+}
+
+static void text_layout_build(text_layout_t &layout, const uint8_t *str, int length, e_font font, int box_width) {
+    const font_definition *def = font_definition_for(font);
+    layout.font = font;
+    layout.box_width = box_width;
+    layout.glyphs.clear();
+    layout.lines.clear();
+    layout.width = text_get_width_direct(str, def);
+
+    if (box_width > 0) {
+        text_layout_wrap(layout, def, str);
+    } else {
+        text_layout_append(layout, def, str, length);
+    }
+}
+
+const text_layout_t &text_layout_get(const uint8_t *str, e_font font, int box_width) {
+    static const uint8_t empty[1] = {0};
+    auto &cache = g_text_layout_cache;
+    if (!str) {
+        str = empty;
+    }
+
+    const uint32_t length = string_length(str);
+    const uint32_t generation = font_generation();
+    const uint32_t key = crc32(str, length) ^ (font * 0x9e3779b1u) ^ (box_width * 0x85ebca6bu);
+
+    auto it = cache.entries.find(key);
+    if (it != cache.entries.end()) {
+        auto &entry = it->second;
+        if (entry.generation == generation && entry.layout.font == font && entry.layout.box_width == box_width
+            && entry.text.size() == length && !memcmp(entry.text.data(), str, length)) {
+            entry.stamp = ++cache.clock;
+            cache.hits++;
+            return entry.layout;
+        }
+    } else if (cache.entries.size() >= TEXT_LAYOUT_CACHE_MAX) {
+        // numbers and dates churn through new strings all the time, keep the recently used half
+        const uint32_t oldest = cache.clock - TEXT_LAYOUT_CACHE_MAX / 2;
+        for (auto e = cache.entries.begin(); e != cache.entries.end();) {
+            e = ((int32_t)(e->second.stamp - oldest) < 0) ? cache.entries.erase(e) : std::next(e);
+        }
+
+        if (cache.entries.size() >= TEXT_LAYOUT_CACHE_MAX) {
+            cache.entries.clear();
+        }
+    }
+
+    cache.misses++;
+    auto &entry = cache.entries[key];
+    entry.text.assign(str, str + length);
+    entry.generation = generation;
+    entry.stamp = ++cache.clock;
+    text_layout_build(entry.layout, str, length, font, box_width);
+    return entry.layout;
+}
+
+int text_layout_draw_line(painter &ctx, const text_layout_t &layout, int line, int x, int y, color color, float scale) {
+    if (line < 0 || line >= (int)layout.lines.size()) {
+        return 0;
+    }
+
+    y = y - 3;
+    const auto &l = layout.lines[line];
+    int current_x = x;
+    for (uint32_t i = l.first, end = l.first + l.count; i < end; ++i) {
+        const auto &glyph = layout.glyphs[i];
+        if (glyph.letter_id >= 0) {
+            ImageDraw::img_letter(ctx, layout.font, glyph.letter_id, current_x, y - glyph.y_offset, color, scale);
+        }
+        current_x += (int)(glyph.advance * scale);
+    }
+    return current_x - x;
+}
+
 uint32_t text_get_max_length_for_width(const uint8_t* str, int length, e_font font, unsigned int requested_width, int invert) {
     const font_definition* def = font_definition_for(font);
+    const int full_length = string_length(str);
     if (!length)
-        length = string_length(str);
+        length = full_length;
+
+    if (g_text_layout_cache.enabled && length == full_length) {
+        const text_layout_t &layout = text_layout_get(str, font);
+        unsigned int width = 0;
+        uint32_t maxlen = 0;
+        if (invert) {
+            for (const auto &glyph : layout.glyphs) {
+                width += glyph.measure;
+            }
+
+            maxlen = length;
+            for (const auto &glyph : layout.glyphs) {
+                if (!maxlen || width <= requested_width)
+                    break;
+
+                width -= glyph.measure;
+                maxlen -= glyph.num_bytes;
+            }
+        } else {
+            for (const auto &glyph : layout.glyphs) {
+                width += glyph.measure;
+                if (width > requested_width)
+                    break;
+
+                maxlen += glyph.num_bytes;
+            }
+        }
+        return maxlen;
+    }
 
     if (invert) {
         unsigned int maxlen = length;
@@ -241,9 +500,6 @@ int text_draw(const uint8_t *str, int x, int y, e_font font, color color) {
 }
 
 int text_draw(painter &ctx, const uint8_t* str, int x, int y, e_font font, color color, float scale) {
-    y = y - 3;
-
-
     const font_definition* def = font_definition_for(font);
     if (!def) {
         return 0;
@@ -254,6 +510,14 @@ int text_draw(painter &ctx, const uint8_t* str, int x, int y, e_font font, color
         return 0;
     }
 
+    // text being edited changes on every key press and needs the cursor walk
+    if (!input_cursor.capture && g_text_layout_cache.enabled) {
+        const text_layout_t &layout = text_layout_get(str, font);
+        return text_layout_draw_line(ctx, layout, 0, x, y, color, scale) + def->space_width;
+    }
+
+    y = y - 3;
+
     if (input_cursor.capture) {
         str += input_cursor.text_offset_start;
         length = input_cursor.text_offset_end - input_cursor.text_offset_start;
@@ -307,6 +571,13 @@ int text_draw(painter &ctx, const uint8_t* str, int x, int y, e_font font, color
     return current_x - x;
 }
 void text_draw_centered(const uint8_t* str, int x, int y, int box_width, e_font font, color color) {
+    if (str && !input_cursor.capture && g_text_layout_cache.enabled) {
+        const text_layout_t &layout = text_layout_get(str, font);
+        painter ctx = game.painter();
+        text_layout_draw_line(ctx, layout, 0, std::max(0, (box_width - layout.width) / 2) + x, y, color);
+        return;
+    }
+
     int offset = (box_width - (int)text_get_width(str, font)) / 2;
     if (offset < 0) {
         offset = 0;
@@ -392,6 +663,17 @@ int text_draw_multiline(const uint8_t* str, int x_offset, int y_offset, int box_
     if (line_height < 11)
         line_height = 11;
 
+    if (box_width > 0 && !input_cursor.capture && g_text_layout_cache.enabled) {
+        const text_layout_t &layout = text_layout_get(str, font, box_width);
+        painter ctx = game.painter();
+        int y = y_offset;
+        for (int line = 0; line < (int)layout.lines.size(); ++line) {
+            text_layout_draw_line(ctx, layout, line, x_offset, y, color);
+            y += line_height + 5;
+        }
+        return y - y_offset;
+    }
+
     int has_more_characters = 1;
     int guard = 0;
     int y = y_offset;
@@ -435,6 +717,10 @@ int text_draw_multiline(const uint8_t* str, int x_offset, int y_offset, int box_
     return y - y_offset;
 }
 int text_measure_multiline(const uint8_t* str, int box_width, e_font font) {
+    if (box_width > 0 && g_text_layout_cache.enabled) {
+        return (int)text_layout_get(str, font, box_width).lines.size();
+    }
+
     int has_more_characters = 1;
     int guard = 0;
     int num_lines = 0;
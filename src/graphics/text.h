@@ -7,9 +7,49 @@
 #include "input/mouse.h"
 
 #include <stdint.h>
+#include <vector>
 
 struct painter;
 
+// letter lookup for one character of a font, single byte characters come from a
+// per font table that is rebuilt when font_generation() changes
+struct font_glyph_t {
+    int16_t letter_id;  // -1 when the font has no letter for the character
+    int16_t width;      // image width without letter spacing
+    int16_t height;
+    int16_t y_offset;   // what image_y_offset() subtracts from y
+    uint8_t num_bytes;
+    uint8_t valid;      // letter image exists
+};
+
+font_glyph_t text_glyph(const font_definition *def, const uint8_t *str);
+
+struct text_layout_t {
+    struct glyph_t {
+        int16_t letter_id; // -1 for spaces and characters that are not drawn
+        int16_t advance;   // pen advance as text_draw() uses it, unscaled
+        int16_t measure;   // width as get_letter_width() counts it
+        int16_t y_offset;
+        uint16_t num_bytes;
+    };
+
+    struct line_t {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    e_font font;
+    int box_width;
+    int width;      // same as text_get_width()
+    std::vector<glyph_t> glyphs;
+    std::vector<line_t> lines; // word wrapped lines for box_width > 0, one line otherwise
+};
+
+// glyphs, positions and line breaks of a string, cached by content, font and wrap width.
+// the reference is valid until the next call
+const text_layout_t &text_layout_get(const uint8_t *str, e_font font, int box_width = 0);
+int text_layout_draw_line(painter &ctx, const text_layout_t &layout, int line, int x, int y, color color, float scale = 1.f);
+
 void text_capture_cursor(int cursor_position, int offset_start, int offset_end);
 void text_draw_cursor(int x_offset, int y_offset, int is_insert);
 
@@ -5,16 +5,18 @@
 #include "grid/grid.h"
 #include "grid/property.h"
 #include "grid/image.h"
+#include "grid/routing/routing_terrain.h"
 #include "game/game_config.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "widget/city/ornaments.h"
+#include "widget/widget_minimap.h"
 
-grid_xx g_buildings_grid = {0, FS_UINT16};
-grid_xx g_damage_grid = {0, FS_UINT16};
-grid_xx g_rubble_type_grid = {0, FS_UINT8};
-grid_xx g_highlight_grid = {0, FS_UINT8};
-grid_xx g_height_building_grid = {0, FS_UINT8};
+grid_t<uint16_t> g_buildings_grid;
+grid_t<uint16_t> g_damage_grid;
+grid_t<uint8_t> g_rubble_type_grid;
+grid_t<uint8_t> g_highlight_grid;
+grid_t<uint8_t> g_height_building_grid;
 
 int map_building_at(int grid_offset) {
     return map_grid_is_valid_offset(grid_offset) ? map_grid_get(g_buildings_grid, grid_offset) : 0;
@@ -23,6 +25,10 @@ int map_building_at(tile2i tile) {
     return map_grid_is_valid_offset(tile.grid_offset()) ? map_grid_get(g_buildings_grid, tile.grid_offset()) : 0;
 }
 void map_building_set(int grid_offset, int building_id) {
+    if (map_grid_get(g_buildings_grid, grid_offset) != building_id) {
+        map_routing_mark_land_dirty(grid_offset);
+        widget_minimap_mark_tile(grid_offset);
+    }
     map_grid_set(g_buildings_grid, grid_offset, building_id);
 }
 void map_building_damage_clear(int grid_offset) {
@@ -73,6 +79,8 @@ void map_set_rubble_building_type(int grid_offset, int type) {
 
 void map_building_clear() {
     map_grid_clear(g_buildings_grid);
+    map_routing_mark_land_dirty_all();
+    widget_minimap_invalidate();
     map_grid_clear(g_damage_grid);
     map_grid_clear(g_rubble_type_grid);
     map_grid_clear(g_height_building_grid);
@@ -3,6 +3,7 @@
 #include "building/monuments.h"
 #include "widget/city/ornaments.h"
 #include "widget/city/tile_draw.h"
+#include "widget/widget_minimap.h"
 #include "graphics/image.h"
 
 #include "building/industry.h"
@@ -97,6 +98,8 @@ void map_building_tiles_add(int building_id, tile2i tile, int size, int image_id
             map_property_set_multi_tile_size(grid_offset, size);
             map_image_set(grid_offset, image_id);
             map_property_set_multi_tile_xy(grid_offset, dx, dy, false);
+            // same building id but maybe a new type, e.g. an evolving house
+            widget_minimap_mark_tile(grid_offset);
         }
     }
     tile2i draw_tile = tile.shifted(x_proper, y_proper);
@@ -5,6 +5,7 @@
 #include "graphics/image.h"
 #include "graphics/graphics.h"
 #include "grid/image.h"
+#include "grid/grid_journal.h"
 #include "grid/tiles.h"
 #include "grid/property.h"
 #include "scenario/map.h"
@@ -26,42 +27,45 @@ struct water_supply_queue_tile {
 
 std::vector<tile2i> *river_access_canal_offsets = nullptr;
 
-static grid_xx canals_grid = {0, FS_UINT8};
-static grid_xx canals_grid_backup = {0, FS_UINT8};
+static grid_t<uint8_t> canals_grid;
+static grid_t<uint8_t> canals_grid_backup;
+static grid_journal_t<uint8_t> canals_journal;
 
 int map_canal_at(int grid_offset) {
     return map_grid_get(canals_grid, grid_offset);
 }
 
 void map_canal_set(int grid_offset, int value) {
+    canals_journal.record(canals_grid, grid_offset);
     map_grid_set(canals_grid, grid_offset, value);
 }
 
 void map_canal_remove(int grid_offset) {
-    map_grid_set(canals_grid, grid_offset, 0);
+    map_canal_set(grid_offset, 0);
     if (map_grid_get(canals_grid, grid_offset + GRID_OFFSET(0, -1)) == 5)
-        map_grid_set(canals_grid, grid_offset + GRID_OFFSET(0, -1), 1);
+        map_canal_set(grid_offset + GRID_OFFSET(0, -1), 1);
 
     if (map_grid_get(canals_grid, grid_offset + GRID_OFFSET(1, 0)) == 6)
-        map_grid_set(canals_grid, grid_offset + GRID_OFFSET(1, 0), 2);
+        map_canal_set(grid_offset + GRID_OFFSET(1, 0), 2);
 
     if (map_grid_get(canals_grid, grid_offset + GRID_OFFSET(0, 1)) == 5)
-        map_grid_set(canals_grid, grid_offset + GRID_OFFSET(0, 1), 3);
+        map_canal_set(grid_offset + GRID_OFFSET(0, 1), 3);
 
     if (map_grid_get(canals_grid, grid_offset + GRID_OFFSET(-1, 0)) == 6)
-        map_grid_set(canals_grid, grid_offset + GRID_OFFSET(-1, 0), 4);
+        map_canal_set(grid_offset + GRID_OFFSET(-1, 0), 4);
 }
 
 void map_canal_clear() {
+    canals_journal.stop();
     map_grid_clear(canals_grid);
 }
 
 void map_canal_backup() {
-    map_grid_copy(canals_grid, canals_grid_backup);
+    canals_journal.begin();
 }
 
 void map_canal_restore(void) {
-    map_grid_copy(canals_grid_backup, canals_grid);
+    canals_journal.restore(canals_grid);
 }
 
 io_buffer* iob_aqueduct_grid = new io_buffer([](io_buffer* iob, size_t version) {
@@ -69,6 +73,7 @@ io_buffer* iob_aqueduct_grid = new io_buffer([](io_buffer* iob, size_t version)
 });
 
 io_buffer *iob_aqueduct_backup_grid = new io_buffer([] (io_buffer *iob, size_t version) {
+    canals_journal.expand(canals_grid, canals_grid_backup);
     iob->bind(BIND_SIGNATURE_GRID, &canals_grid_backup);
 });
 
@@ -3,6 +3,7 @@
 #include "building/building.h"
 #include "building/model.h"
 #include "core/calc.h"
+#include "core/log.h"
 #include "core/profiler.h"
 #include "grid/grid.h"
 #include "grid/property.h"
@@ -11,10 +12,17 @@
 #include "io/io_buffer.h"
 #include "scenario/map.h"
 #include "city/city.h"
+#include "city/city_buildings.h"
+#include "dev/debug.h"
 
 #include "js/js_game.h"
 
-grid_xx g_desirability_grid = {0, FS_INT8};
+#include <memory>
+
+grid_t<int8_t> g_desirability_grid;
+// unclamped sum of every stamp, so a stamp can be taken back exactly after the visible grid saturated
+grid_t<int32_t> g_desirability_sum;
+grid_t<uint8_t> g_desirability_terrain_sources;
 desirability_t g_desirability;
 
 ANK_REGISTER_CONFIG_ITERATOR(config_load_desirability);
@@ -22,6 +30,24 @@ void config_load_desirability() {
     g_desirability.load();
 }
 
+declare_console_command_p(desirability) {
+    std::string args; is >> args;
+
+    if (args == "full") {
+        g_desirability.mode = desirability_t::MODE_FULL;
+    } else if (args == "incremental") {
+        g_desirability.mode = desirability_t::MODE_INCREMENTAL;
+    } else if (args == "verify") {
+        g_desirability.mode = desirability_t::MODE_VERIFY;
+    } else if (args == "check") {
+        os << "mismatched tiles: " << g_desirability.verify() << std::endl;
+        return;
+    }
+
+    pcstr modes[] = {"full", "incremental", "verify"};
+    os << "desirability update mode: " << modes[g_desirability.mode] << std::endl;
+}
+
 void desirability_t::load() {
     g_config_arch.r_section("desirability", [this] (archive arch) {
         std::pair<pcstr, desirability_t::influence_t *> items[] = {
@@ -41,6 +67,9 @@ void desirability_t::load() {
             });
         }
     });
+
+    // influences feed every stamp, old stamps cannot be taken back with new values
+    need_full_rebuild = true;
 }
 
 void desirability_t::add_to_terrain_at_distance(tile2i tile, int size, int distance, int desirability) {
@@ -63,17 +92,17 @@ void desirability_t::add_to_terrain_at_distance(tile2i tile, int size, int dista
         for (int i = start; i < end; i++) {
             const ring_tile* tile = map_ring_tile(i);
             if (map_ring_is_inside_map(x + tile->x, y + tile->y)) {
-                map_grid_set(g_desirability_grid,
-                             base_offset + tile->grid_offset,
-                             calc_bound(map_grid_get(g_desirability_grid, base_offset + tile->grid_offset) + desirability, -100, 100));
+                const int offset = base_offset + tile->grid_offset;
+                g_desirability_sum[offset] += desirability;
+                g_desirability_grid.set(offset, calc_bound(g_desirability_sum.get(offset), -100, 100));
             }
         }
     } else {
         for (int i = start; i < end; i++) {
             const ring_tile* tile = map_ring_tile(i);
-            map_grid_set(g_desirability_grid,
-                         base_offset + tile->grid_offset,
-                         calc_bound(map_grid_get(g_desirability_grid, base_offset + tile->grid_offset) + desirability, -100, 100));
+            const int offset = base_offset + tile->grid_offset;
+            g_desirability_sum[offset] += desirability;
+            g_desirability_grid.set(offset, calc_bound(g_desirability_sum.get(offset), -100, 100));
         }
     }
 }
@@ -98,55 +127,166 @@ void desirability_t::add_to_terrain(tile2i tile, int size, int desirability, int
     }
 }
 
+desirability_t::stamp_t desirability_t::building_stamp(building &b) const {
+    if (!b.is_valid()) {
+        return {};
+    }
+
+    const model_building *model = model_get_building(b.type);
+    stamp_t stamp;
+    stamp.tile = b.tile;
+    stamp.size = b.size;
+    stamp.value = model->desirability_value;
+    stamp.step = model->desirability_step;
+    stamp.step_size = model->desirability_step_size;
+    stamp.range = model->desirability_range;
+    return stamp;
+}
+
+desirability_t::stamp_t desirability_t::terrain_stamp(tile2i tile, e_terrain_source source) const {
+    const influence_t *inf = nullptr;
+    switch (source) {
+    case SOURCE_PLAZA: inf = &influence.plaza; break;
+    case SOURCE_EARTHQUAKE: inf = &influence.earthquake; break;
+    case SOURCE_GARDEN: inf = &influence.garden; break;
+    case SOURCE_RUBBLE: inf = &influence.rubble; break;
+    default: return {};
+    }
+
+    stamp_t stamp;
+    stamp.tile = tile;
+    stamp.size = inf->size;
+    stamp.value = inf->value;
+    stamp.step = inf->step;
+    stamp.step_size = inf->step_size;
+    stamp.range = inf->range;
+    return stamp;
+}
+
+desirability_t::e_terrain_source desirability_t::terrain_source(int grid_offset) {
+    int terrain = map_terrain_get(grid_offset);
+    if (map_property_is_plaza_or_earthquake(tile2i(grid_offset))) {
+        if (terrain & TERRAIN_ROAD) {
+            return SOURCE_PLAZA;
+        } else if (terrain & TERRAIN_ROCK) {
+            // earthquake fault line: slight negative
+            return SOURCE_EARTHQUAKE;
+        }
+
+        // invalid plaza/earthquake flag
+        assert(false);
+        map_property_clear_plaza_or_earthquake(grid_offset);
+        return SOURCE_NONE;
+    } else if (terrain & TERRAIN_GARDEN) {
+        return SOURCE_GARDEN;
+    } else if (terrain & TERRAIN_RUBBLE) {
+        return SOURCE_RUBBLE;
+    }
+
+    return SOURCE_NONE;
+}
+
+void desirability_t::apply(const stamp_t &stamp, int sign) {
+    if (stamp.size > 0) {
+        // negating both the base value and the step size takes back exactly what was added
+        add_to_terrain(stamp.tile, stamp.size, sign * stamp.value, stamp.step, sign * stamp.step_size, stamp.range);
+    }
+}
+
 void desirability_t::update_buildings() {
+    building_stamps.assign(MAX_BUILDINGS, stamp_t{});
     buildings_valid_do([this] (building &b) {
-        const model_building *model = model_get_building(b.type);
-        add_to_terrain(b.tile, b.size, model->desirability_value, model->desirability_step, model->desirability_step_size, model->desirability_range);
+        building_stamps[b.id] = building_stamp(b);
+        apply(building_stamps[b.id], 1);
     });
 }
 
 void desirability_t::update_terrain() {
     int grid_offset = scenario_map_data()->start_offset;
-    tile2i tile(grid_offset);
     for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
         for (int x = 0; x < scenario_map_data()->width; x++, grid_offset++) {
-            int terrain = map_terrain_get(grid_offset);
-            tile2i tile(x, y);
-            influence_t tileinf;
-            if (map_property_is_plaza_or_earthquake(tile)) {                
-                if (terrain & TERRAIN_ROAD) {
-                    tileinf = influence.plaza;
-                } else if (terrain & TERRAIN_ROCK) {
-                    // earthquake fault line: slight negative
-                    tileinf = influence.earthquake;
-                } else {
-                    // invalid plaza/earthquake flag
-                    assert(false);
-                    map_property_clear_plaza_or_earthquake(grid_offset);
-                    continue;
-                }
-            } else if (terrain & TERRAIN_GARDEN) {
-                tileinf = influence.garden;
-            } else if (terrain & TERRAIN_RUBBLE) {
-                tileinf = influence.rubble;
-            }
-
-            if (tileinf.size > 0) {
-                add_to_terrain(tile, tileinf.size, tileinf.value, tileinf.step, tileinf.step_size, tileinf.range);
-            }
+            const e_terrain_source source = terrain_source(grid_offset);
+            g_desirability_terrain_sources[grid_offset] = source;
+            apply(terrain_stamp(tile2i(x, y), source), 1);
         }
     }
 }
 
 void desirability_t::clear() {
     map_grid_clear(g_desirability_grid);
+    map_grid_clear(g_desirability_sum);
+    map_grid_clear(g_desirability_terrain_sources);
+    building_stamps.clear();
+    need_full_rebuild = true;
 }
 
-void desirability_t::update() {
-    OZZY_PROFILER_SECTION("Game/Run/Tick/Desirability Update");
+void desirability_t::rebuild_full() {
+    OZZY_PROFILER_SECTION("Game/Run/Tick/Desirability Update/Full");
     clear();
     update_buildings();
     update_terrain();
+    need_full_rebuild = false;
+}
+
+void desirability_t::update_incremental() {
+    OZZY_PROFILER_SECTION("Game/Run/Tick/Desirability Update/Incremental");
+    for (auto &b : city_buildings()) {
+        stamp_t &old_stamp = building_stamps[b.id];
+        const stamp_t new_stamp = building_stamp(b);
+        if (old_stamp != new_stamp) {
+            apply(old_stamp, -1);
+            apply(new_stamp, 1);
+            old_stamp = new_stamp;
+        }
+    }
+
+    int grid_offset = scenario_map_data()->start_offset;
+    for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
+        for (int x = 0; x < scenario_map_data()->width; x++, grid_offset++) {
+            const auto old_source = (e_terrain_source)g_desirability_terrain_sources[grid_offset];
+            const auto new_source = terrain_source(grid_offset);
+            if (old_source != new_source) {
+                apply(terrain_stamp(tile2i(x, y), old_source), -1);
+                apply(terrain_stamp(tile2i(x, y), new_source), 1);
+                g_desirability_terrain_sources[grid_offset] = new_source;
+            }
+        }
+    }
+}
+
+int desirability_t::verify() {
+    auto incremental = std::make_unique<grid_t<int8_t>>();
+    map_grid_copy(g_desirability_grid, *incremental);
+
+    rebuild_full();
+
+    int mismatches = 0;
+    for (int i = 0; i < GRID_SIZE_TOTAL; i++) {
+        if (incremental->items[i] != g_desirability_grid.items[i]) {
+            if (!mismatches) {
+                logs::warn("desirability: incremental grid differs at %d,%d (%d != %d)", GRID_X(i), GRID_Y(i), incremental->items[i], g_desirability_grid.items[i]);
+            }
+            ++mismatches;
+        }
+    }
+
+    if (mismatches) {
+        logs::warn("desirability: %d tiles differ from the full rebuild", mismatches);
+    }
+    return mismatches;
+}
+
+void desirability_t::update() {
+    OZZY_PROFILER_SECTION("Game/Run/Tick/Desirability Update");
+    if (mode == MODE_FULL || need_full_rebuild) {
+        rebuild_full();
+        return;
+    }
+
+    update_incremental();
+    if (mode == MODE_VERIFY) {
+        verify();
+    }
 }
 
 int desirability_t::get(int grid_offset) {
@@ -179,8 +319,7 @@ int desirability_t::get_avg(tile2i tile, int size) {
     int count = 1;
     for (int y = area.tmin.y(), endy = area.tmax.y(); y <= endy; y++) {
         for (int x = area.tmin.x(), endx = area.tmax.x(); x <= endx; x++) {
-            int grid_offset = MAP_OFFSET(x, y);
-            summ += map_grid_get(g_desirability_grid, grid_offset);
+            summ += g_desirability_grid.get(MAP_OFFSET(x, y));
             count++;
         }
     }
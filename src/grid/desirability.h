@@ -2,7 +2,41 @@
 
 #include "grid/point.h"
 
+#include <vector>
+
+class building;
+
 struct desirability_t {
+    enum e_mode {
+        MODE_FULL,        // clear and re-stamp every source each update
+        MODE_INCREMENTAL, // re-stamp only the sources that changed since the last update
+        MODE_VERIFY,      // incremental, then compare against a full rebuild
+    };
+
+    enum e_terrain_source : uint8_t {
+        SOURCE_NONE,
+        SOURCE_PLAZA,
+        SOURCE_EARTHQUAKE,
+        SOURCE_GARDEN,
+        SOURCE_RUBBLE,
+    };
+
+    // what one building or terrain tile added to the grid, kept so it can be taken back
+    struct stamp_t {
+        tile2i tile{};
+        int16_t size = 0;
+        int16_t value = 0;
+        int16_t step = 0;
+        int16_t step_size = 0;
+        int16_t range = 0;
+
+        bool operator==(const stamp_t &o) const {
+            return size == o.size && tile.grid_offset() == o.tile.grid_offset() && value == o.value && step == o.step
+                   && step_size == o.step_size && range == o.range;
+        }
+        bool operator!=(const stamp_t &o) const { return !(*this == o); }
+    };
+
     struct influence_t {
         int size = 0;
         int value = 0;
@@ -18,12 +52,24 @@ struct desirability_t {
         influence_t rubble;
     } influence;
 
+    e_mode mode = MODE_INCREMENTAL;
+    bool need_full_rebuild = true;
+    std::vector<stamp_t> building_stamps;
+
     void update_terrain();
     void clear();
     void update();
     void update_buildings();
+    void rebuild_full();
+    void update_incremental();
+    int verify();
     void load();
 
+    stamp_t building_stamp(building &b) const;
+    stamp_t terrain_stamp(tile2i tile, e_terrain_source source) const;
+    e_terrain_source terrain_source(int grid_offset);
+    void apply(const stamp_t &stamp, int sign);
+
     void add_to_terrain_at_distance(tile2i tile, int size, int distance, int desirability);
     void add_to_terrain(tile2i tile, int size, int desirability, int step, int step_size, int range);
     int get(int grid_offset);
@@ -7,10 +7,11 @@
 #include "graphics/view/lookup.h"
 #include "graphics/view/view.h"
 #include "city/city_figures.h"
+#include "grid/figure_index.h"
 
 #include <assert.h>
 
-static grid_xx grid_figures = {0, FS_UINT16};
+static grid_t<uint16_t> grid_figures;
 svector<figure *, 5000> g_figures_y_sort;
 
 bool map_has_figure_at(int grid_offset) {
@@ -31,6 +32,7 @@ void map_figure_sort_by_y() {
         if (f->tile.x() >= GRID_LENGTH || f->tile.y() > GRID_LENGTH) {
             f->tile = {-1, -1};
             f->cached_pos = {-1, -1};
+            map_figure_index_update(*f);
             f->poof();
             continue;
         }
@@ -0,0 +1,139 @@
+#include "figure_index.h"
+
+#include "figure/properties.h"
+#include "core/log.h"
+#include "dev/debug.h"
+
+#include <algorithm>
+
+figure_index_t g_figure_index;
+static uint32_t g_figure_index_mismatches = 0;
+
+figure_index_t::figure_index_t() {
+    std::fill(std::begin(cell_of), std::end(cell_of), NOT_INDEXED);
+    std::fill(std::begin(category_of), std::end(category_of), 0);
+}
+
+declare_console_command_p(figindex) {
+    std::string args; is >> args;
+
+    auto &index = g_figure_index;
+    if (args == "scan") {
+        index.mode = FIGURE_INDEX_SCAN;
+    } else if (args == "index") {
+        index.mode = FIGURE_INDEX_CELLS;
+    } else if (args == "verify") {
+        map_figure_index_sync();
+        index.mode = FIGURE_INDEX_VERIFY;
+        g_figure_index_mismatches = 0;
+    }
+
+    pcstr names[] = {"scan", "index", "verify"};
+    os << "figure index mode: " << names[index.mode] << ", mismatches " << g_figure_index_mismatches << std::endl;
+}
+
+static uint8_t figure_index_category(figure &f) {
+    switch (f.type) {
+    case FIGURE_TOMB_ROBER:
+    case FIGURE_INDIGENOUS_NATIVE:
+    case FIGURE_PROTESTER:
+    case FIGURE_HYENA:
+        return FIGURE_INDEX_HOSTILE;
+
+    case FIGURE_INFANTRY:
+    case FIGURE_ARCHER:
+    case FIGURE_FCHARIOTEER:
+        return FIGURE_INDEX_SOLDIER;
+
+    default:
+        ; // nothing
+    }
+
+    if (f.is_enemy()) {
+        return FIGURE_INDEX_HOSTILE;
+    }
+
+    if (f.is_herd() || figure_properties_for_type(f.type)->category == FIGURE_CATEGORY_ANIMAL) {
+        return FIGURE_INDEX_ANIMAL;
+    }
+
+    return FIGURE_INDEX_CITIZEN;
+}
+
+static int figure_index_cell(figure &f) {
+    const int x = f.tile.x();
+    const int y = f.tile.y();
+    if (x < 0 || y < 0 || x >= GRID_LENGTH || y >= GRID_LENGTH) {
+        return figure_index_t::OUTSIDE;
+    }
+
+    return (y / figure_index_t::CELL) * figure_index_t::CELLS + x / figure_index_t::CELL;
+}
+
+static void figure_index_unlink(figure_index_t &index, int figure_id) {
+    auto &bucket = index.cells[index.cell_of[figure_id]][index.category_of[figure_id]];
+    auto it = std::find(bucket.begin(), bucket.end(), figure_id);
+    if (it != bucket.end()) {
+        *it = bucket.back();
+        bucket.pop_back();
+    }
+    index.cell_of[figure_id] = figure_index_t::NOT_INDEXED;
+}
+
+void map_figure_index_update(figure &f) {
+    // slot 0 is the scratch figure handed out when the pool is full
+    if (f.id <= 0 || f.id >= MAX_FIGURES) {
+        return;
+    }
+
+    if (!f.is_valid()) {
+        map_figure_index_remove(f.id);
+        return;
+    }
+
+    auto &index = g_figure_index;
+    const int cell = figure_index_cell(f);
+    const uint8_t category = figure_index_category(f);
+    if (index.cell_of[f.id] == cell && index.category_of[f.id] == category) {
+        return;
+    }
+
+    if (index.cell_of[f.id] != figure_index_t::NOT_INDEXED) {
+        figure_index_unlink(index, f.id);
+    }
+
+    index.cells[cell][category].push_back(f.id);
+    index.cell_of[f.id] = cell;
+    index.category_of[f.id] = category;
+}
+
+void map_figure_index_remove(int figure_id) {
+    auto &index = g_figure_index;
+    if (figure_id <= 0 || figure_id >= MAX_FIGURES || index.cell_of[figure_id] == figure_index_t::NOT_INDEXED) {
+        return;
+    }
+
+    figure_index_unlink(index, figure_id);
+}
+
+void map_figure_index_clear() {
+    auto &index = g_figure_index;
+    for (auto &cell : index.cells) {
+        for (auto &bucket : cell) {
+            bucket.clear();
+        }
+    }
+    std::fill(std::begin(index.cell_of), std::end(index.cell_of), figure_index_t::NOT_INDEXED);
+}
+
+void map_figure_index_sync() {
+    for (figure *f : map_figures()) {
+        map_figure_index_update(*f);
+    }
+}
+
+void map_figure_index_mismatch(pcstr query, figure_index_result_t scan, figure_index_result_t indexed) {
+    if (g_figure_index_mismatches++ < 16) {
+        logs::error("figure index: %s query found figure %d (score %d), the scan found %d (score %d)", query, indexed.id, indexed.score, scan.id, scan.score);
+    }
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "grid/grid.h"
+#include "grid/point.h"
+#include "figure/figure.h"
+#include "city/city_figures.h"
+
+#include <cstdint>
+#include <vector>
+
+// figures bucketed by 8x8 tile cells and a coarse category, so proximity queries
+// (combat targets, is_nearby, animals) only visit the cells around the asking tile
+// instead of every slot in the figure pool
+enum e_figure_index_category {
+    FIGURE_INDEX_HOSTILE = 0, // enemies, tomb robbers, natives, protesters, hyenas
+    FIGURE_INDEX_SOLDIER,
+    FIGURE_INDEX_ANIMAL,
+    FIGURE_INDEX_CITIZEN, // everything else
+    FIGURE_INDEX_CATEGORIES
+};
+
+enum {
+    FIGURE_INDEX_MASK_HOSTILE = 1 << FIGURE_INDEX_HOSTILE,
+    FIGURE_INDEX_MASK_SOLDIER = 1 << FIGURE_INDEX_SOLDIER,
+    FIGURE_INDEX_MASK_ANIMAL = 1 << FIGURE_INDEX_ANIMAL,
+    FIGURE_INDEX_MASK_CITIZEN = 1 << FIGURE_INDEX_CITIZEN,
+    FIGURE_INDEX_MASK_ALL = (1 << FIGURE_INDEX_CATEGORIES) - 1,
+};
+
+enum e_figure_index_mode {
+    FIGURE_INDEX_SCAN,   // walk the whole pool like before
+    FIGURE_INDEX_CELLS,  // visit only the cells that can hold a better candidate
+    FIGURE_INDEX_VERIFY, // run both, log when they disagree and keep the scan result
+};
+
+struct figure_index_result_t {
+    int id;
+    int score;
+
+    bool operator==(const figure_index_result_t &o) const { return id == o.id && score == o.score; }
+    bool operator!=(const figure_index_result_t &o) const { return !(*this == o); }
+};
+
+struct figure_index_t {
+    static constexpr int CELL = 8;
+    static constexpr int CELLS = (GRID_LENGTH + CELL - 1) / CELL;
+    static constexpr int OUTSIDE = CELLS * CELLS; // figures without a tile on the map
+    static constexpr int NOT_INDEXED = -1;
+
+    using bucket = std::vector<uint16_t>;
+
+    bucket cells[OUTSIDE + 1][FIGURE_INDEX_CATEGORIES];
+    int16_t cell_of[MAX_FIGURES];
+    uint8_t category_of[MAX_FIGURES];
+    e_figure_index_mode mode = FIGURE_INDEX_CELLS;
+
+    figure_index_t();
+
+    // best candidate by score, ties go to the lowest id the same way the old scans in id order did.
+    // score(figure&) returns a negative value to skip the figure, otherwise a value not lower than
+    // the tile distance to center, which is what lets the search stop at the first ring that can't win.
+    // only scores strictly below initial_score are taken, accept(figure&) runs on improving candidates only
+    template<typename Score, typename Accept>
+    figure_index_result_t nearest(tile2i center, int radius, int mask, int initial_score, Score score, Accept accept);
+
+    template<typename Score>
+    figure_index_result_t nearest(tile2i center, int radius, int mask, int initial_score, Score score) {
+        return nearest(center, radius, mask, initial_score, score, [] (figure &) { return true; });
+    }
+
+    // lowest id accepted by pred, for the "take the first one" fallbacks
+    template<typename Pred>
+    int lowest(int mask, Pred pred);
+
+private:
+    template<typename Score, typename Accept>
+    static void offer(figure_index_result_t &best, figure &f, Score &score, Accept &accept) {
+        const int s = score(f);
+        if (s < 0) {
+            return;
+        }
+
+        const bool better = s < best.score || (best.id && s == best.score && f.id < best.id);
+        if (better && accept(f)) {
+            best = {f.id, s};
+        }
+    }
+
+    template<typename Score, typename Accept>
+    void visit(figure_index_result_t &best, int cell, int mask, Score &score, Accept &accept) {
+        for (int c = 0; c < FIGURE_INDEX_CATEGORIES; ++c) {
+            if (!(mask & (1 << c))) {
+                continue;
+            }
+
+            for (uint16_t id : cells[cell][c]) {
+                offer(best, *figure_get(id), score, accept);
+            }
+        }
+    }
+
+    template<typename Score, typename Accept>
+    figure_index_result_t nearest_scan(int initial_score, Score &score, Accept &accept);
+
+    template<typename Score, typename Accept>
+    figure_index_result_t nearest_cells(tile2i center, int radius, int mask, int initial_score, Score &score, Accept &accept);
+
+    template<typename Pred>
+    int lowest_scan(Pred &pred);
+
+    template<typename Pred>
+    int lowest_cells(int mask, Pred &pred);
+};
+
+extern figure_index_t g_figure_index;
+
+void map_figure_index_update(figure &f); // after the tile or the type of a figure changed
+void map_figure_index_remove(int figure_id);
+void map_figure_index_clear();
+void map_figure_index_sync(); // re-reads every figure in the pool
+void map_figure_index_mismatch(pcstr query, figure_index_result_t scan, figure_index_result_t indexed);
+
+template<typename Score, typename Accept>
+figure_index_result_t figure_index_t::nearest_scan(int initial_score, Score &score, Accept &accept) {
+    figure_index_result_t best{0, initial_score};
+    for (figure *f : map_figures()) {
+        if (!f->id || !f->is_valid()) {
+            continue;
+        }
+
+        offer(best, *f, score, accept);
+    }
+    return best;
+}
+
+template<typename Score, typename Accept>
+figure_index_result_t figure_index_t::nearest_cells(tile2i center, int radius, int mask, int initial_score, Score &score, Accept &accept) {
+    figure_index_result_t best{0, initial_score};
+    visit(best, OUTSIDE, mask, score, accept);
+
+    const int x = center.x();
+    const int y = center.y();
+    if (x < 0 || y < 0 || x >= GRID_LENGTH || y >= GRID_LENGTH) {
+        for (int cell = 0; cell < OUTSIDE; ++cell) {
+            visit(best, cell, mask, score, accept);
+        }
+        return best;
+    }
+
+    const int cx = x / CELL;
+    const int cy = y / CELL;
+    for (int r = 0; r < CELLS; ++r) {
+        // a figure r cells away is at least this many tiles away
+        const int lower_bound = r ? (r - 1) * CELL + 1 : 0;
+        if (lower_bound > best.score || (radius >= 0 && lower_bound > radius)) {
+            break;
+        }
+
+        for (int yy = cy - r; yy <= cy + r; ++yy) {
+            if (yy < 0 || yy >= CELLS) {
+                continue;
+            }
+
+            // inner rows of the ring only have their two end cells
+            const bool edge_row = (yy == cy - r || yy == cy + r);
+            const int step = edge_row ? 1 : 2 * r;
+            for (int xx = cx - r; xx <= cx + r; xx += step) {
+                if (xx >= 0 && xx < CELLS) {
+                    visit(best, yy * CELLS + xx, mask, score, accept);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+template<typename Score, typename Accept>
+figure_index_result_t figure_index_t::nearest(tile2i center, int radius, int mask, int initial_score, Score score, Accept accept) {
+    switch (mode) {
+    case FIGURE_INDEX_SCAN:
+        return nearest_scan(initial_score, score, accept);
+
+    case FIGURE_INDEX_VERIFY: {
+        const figure_index_result_t scan = nearest_scan(initial_score, score, accept);
+        const figure_index_result_t indexed = nearest_cells(center, radius, mask, initial_score, score, accept);
+        if (scan != indexed) {
+            map_figure_index_mismatch("nearest", scan, indexed);
+        }
+        return scan;
+    }
+
+    default:
+        return nearest_cells(center, radius, mask, initial_score, score, accept);
+    }
+}
+
+template<typename Pred>
+int figure_index_t::lowest_scan(Pred &pred) {
+    for (figure *f : map_figures()) {
+        if (f->id && f->is_valid() && pred(*f)) {
+            return f->id;
+        }
+    }
+    return 0;
+}
+
+template<typename Pred>
+int figure_index_t::lowest_cells(int mask, Pred &pred) {
+    int best = 0;
+    for (int cell = 0; cell <= OUTSIDE; ++cell) {
+        for (int c = 0; c < FIGURE_INDEX_CATEGORIES; ++c) {
+            if (!(mask & (1 << c))) {
+                continue;
+            }
+
+            for (uint16_t id : cells[cell][c]) {
+                if ((!best || id < best) && pred(*figure_get(id))) {
+                    best = id;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+template<typename Pred>
+int figure_index_t::lowest(int mask, Pred pred) {
+    switch (mode) {
+    case FIGURE_INDEX_SCAN:
+        return lowest_scan(pred);
+
+    case FIGURE_INDEX_VERIFY: {
+        const int scan = lowest_scan(pred);
+        const int indexed = lowest_cells(mask, pred);
+        if (scan != indexed) {
+            map_figure_index_mismatch("lowest", {scan, 0}, {indexed, 0});
+        }
+        return scan;
+    }
+
+    default:
+        return lowest_cells(mask, pred);
+    }
+}
@@ -20,7 +20,7 @@
 
 #include <cstdint>
 #include <algorithm>
-#include <random>
+#include "core/random.h"
 
 constexpr uint32_t PH_FLOODPLAIN_GROWTH_MAX = 6;
 
@@ -49,11 +49,11 @@ void foreach_floodplain_row(int is_flooding, int row, void (*callback)(int is_fl
     }
 }
 
-grid_xx g_terrain_floodplain_row = {0, FS_UINT8};
-grid_xx g_terrain_floodplain_growth = { 0, FS_UINT8 };
-grid_xx g_terrain_floodplain_fertility = {0, FS_UINT8};
-grid_xx g_terrain_floodplain_max_fertile = {0, FS_UINT8};
-grid_xx g_terrain_floodplain_flood_shore = {0, FS_UINT8};
+grid_t<uint8_t> g_terrain_floodplain_row;
+grid_t<uint8_t> g_terrain_floodplain_growth;
+grid_t<uint8_t> g_terrain_floodplain_fertility;
+grid_t<uint8_t> g_terrain_floodplain_max_fertile;
+grid_t<uint8_t> g_terrain_floodplain_flood_shore;
 
 void map_floodplain_advance_growth() {
     static int floodplain_growth_advance = 0;
@@ -68,9 +68,7 @@ void map_floodplain_advance_growth() {
             return (image_id == 0 || want_growth == 0);
         });
 
-        std::random_device rd;
-        std::mt19937 random(rd());
-        std::shuffle(floodplain_tiles_local.begin(), floodplain_tiles_local.end(), random);
+        std::shuffle(floodplain_tiles_local.begin(), floodplain_tiles_local.end(), random_sim_engine{});
 
         int size = std::min(floodplain_tiles_random.size() / 12, floodplain_tiles_local.size());
         for (int i = 0; i < size; ++i) {
@@ -218,9 +216,7 @@ int map_floodplain_rebuild_rows() {
         }
     });
 
-    std::random_device rd;
-    std::mt19937 random(rd());
-    std::shuffle(floodplain_tiles_random.begin(), floodplain_tiles_random.end(), random);
+    std::shuffle(floodplain_tiles_random.begin(), floodplain_tiles_random.end(), random_sim_engine{});
 
     // fill in shore order data
     for (int row = -1; row < MAX_FLOODPLAIN_ROWS - 1; row++) {
@@ -8,6 +8,10 @@
 #include "core/core_utility.h"
 
 #include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <string.h>
 #include <stdint.h>
 
 class building;
@@ -28,27 +32,21 @@ inline uint32_t MAP_OFFSET(tile2i point) {
     return scenario_map_data()->start_offset + GRID_OFFSET(point.x(), point.y());
 }
 
-enum e_grid_data_type {
-    FS_NONE = 0,
-    FS_UINT8 = 1,
-    FS_INT8 = 2,
-    FS_UINT16 = 3,
-    FS_INT16 = 4,
-    FS_UINT32 = 5,
-    FS_INT32 = 6
-};
+template<typename T>
+struct grid_t {
+    using value_type = T;
 
-static size_t gr_sizes[] = {
-    0, sizeof(uint8_t), sizeof(int8_t), sizeof(uint16_t), sizeof(int16_t), sizeof(uint32_t), sizeof(int32_t)
-};
+    T items[GRID_SIZE_TOTAL] = {};
 
-struct grid_xx {
-    int initialized;
-    e_grid_data_type datatype;
-    size_t size_field;
-    int size_total;
+    // unchecked accessors, callers must pass a valid offset (hot loops only)
+    inline T get(uint32_t at) const { return items[at]; }
+    inline void set(uint32_t at, T value) { items[at] = value; }
+    inline T &operator[](uint32_t at) { return items[at]; }
+    inline const T &operator[](uint32_t at) const { return items[at]; }
 
-    void* items_xx;
+    inline T *data() { return items; }
+    inline const T *data() const { return items; }
+    static constexpr size_t size_total() { return sizeof(T) * GRID_SIZE_TOTAL; }
 };
 
 struct grid_area {
@@ -82,20 +80,88 @@ struct grid_area {
 
 using grid_tiles = std::vector<tile2i>;
 
-void map_grid_init(grid_xx& grid);
-int32_t map_grid_get(grid_xx& grid, uint32_t at);
-inline int32_t map_grid_get(grid_xx &grid, tile2i at) { return map_grid_get(grid, at.grid_offset()); }
-void map_grid_set(grid_xx& grid, uint32_t at, int64_t value);
-void map_grid_fill(grid_xx& grid, int64_t value);
-void map_grid_clear(grid_xx& grid);
-void map_grid_copy(grid_xx& src, grid_xx& dst);
+// checked accessors, safe to use with offsets coming from scripts/debug ui
+template<typename T>
+inline int32_t map_grid_get(const grid_t<T> &grid, uint32_t at) {
+    return (at < GRID_SIZE_TOTAL) ? (int32_t)grid.items[at] : 0;
+}
+
+template<typename T>
+inline int32_t map_grid_get(const grid_t<T> &grid, tile2i at) { return map_grid_get(grid, at.grid_offset()); }
+
+template<typename T>
+inline void map_grid_set(grid_t<T> &grid, uint32_t at, int64_t value) {
+    if (at < GRID_SIZE_TOTAL) {
+        grid.items[at] = (T)value;
+    }
+}
+
+template<typename T>
+inline void map_grid_fill(grid_t<T> &grid, int64_t value) {
+    std::fill(std::begin(grid.items), std::end(grid.items), (T)value);
+}
+
+template<typename T>
+inline void map_grid_clear(grid_t<T> &grid) {
+    memset(grid.items, 0, grid_t<T>::size_total());
+}
+
+template<typename T>
+inline void map_grid_copy(const grid_t<T> &src, grid_t<T> &dst) {
+    memcpy(dst.items, src.items, grid_t<T>::size_total());
+}
+
+template<typename T>
+inline void map_grid_and(grid_t<T> &grid, uint32_t at, int mask) {
+    if (at < GRID_SIZE_TOTAL) {
+        grid.items[at] &= (T)mask;
+    }
+}
+
+template<typename T>
+inline void map_grid_or(grid_t<T> &grid, uint32_t at, int mask) {
+    if (at < GRID_SIZE_TOTAL) {
+        grid.items[at] |= (T)mask;
+    }
+}
+
+template<typename T>
+inline void map_grid_and_all(grid_t<T> &grid, int mask) {
+    for (T &v : grid.items) {
+        v &= (T)mask;
+    }
+}
 
-void map_grid_and(grid_xx& grid, uint32_t at, int mask);
-void map_grid_or(grid_xx& grid, uint32_t at, int mask);
-void map_grid_and_all(grid_xx& grid, int mask);
+// savegame layout is little-endian per item, same as the old runtime-typed grids
+template<typename T>
+void map_grid_save_buffer(const grid_t<T> &grid, buffer *buf) {
+    if constexpr (sizeof(T) == 1) {
+        buf->write_raw(grid.items, GRID_SIZE_TOTAL);
+    } else {
+        for (const T v : grid.items) {
+            if constexpr (std::is_same_v<T, uint16_t>) { buf->write_u16(v); }
+            else if constexpr (std::is_same_v<T, int16_t>) { buf->write_i16(v); }
+            else if constexpr (std::is_same_v<T, uint32_t>) { buf->write_u32(v); }
+            else if constexpr (std::is_same_v<T, int32_t>) { buf->write_i32(v); }
+            else { static_assert(sizeof(T) == 0, "unsupported grid type"); }
+        }
+    }
+}
 
-void map_grid_save_buffer(grid_xx& grid, buffer* buf);
-void map_grid_load_buffer(grid_xx& grid, buffer* buf);
+template<typename T>
+void map_grid_load_buffer(grid_t<T> &grid, buffer *buf) {
+    if constexpr (sizeof(T) == 1) {
+        buf->read_raw(grid.items, GRID_SIZE_TOTAL);
+    } else {
+        for (T &v : grid.items) {
+            if constexpr (std::is_same_v<T, uint16_t>) { v = buf->read_u16(); }
+            else if constexpr (std::is_same_v<T, int16_t>) { v = buf->read_i16(); }
+            else if constexpr (std::is_same_v<T, uint32_t>) { v = buf->read_u32(); }
+            else if constexpr (std::is_same_v<T, int32_t>) { v = buf->read_i32(); }
+            else { static_assert(sizeof(T) == 0, "unsupported grid type"); }
+        }
+    }
+}
 
 // void map_grid_data_init(int width, int height, int start_offset, int border_size);
 
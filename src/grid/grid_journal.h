@@ -0,0 +1,101 @@
+#pragma once
+
+#include "grid/grid.h"
+
+#include <vector>
+
+// original values of the tiles written since begin(), first write per tile wins.
+// undo puts back only what was touched during a build transaction instead of
+// keeping full backup copies of every grid
+template<typename T>
+struct grid_journal_t {
+    struct entry_t {
+        uint32_t offset;
+        T value;
+    };
+
+    std::vector<entry_t> entries;
+    std::vector<int32_t> slots; // grid offset -> index in entries, -1 if not touched yet
+    bool recording = false;
+
+    void begin() {
+        clear();
+        recording = true;
+    }
+
+    void stop() {
+        clear();
+        recording = false;
+    }
+
+    void clear() {
+        for (const auto &e : entries) {
+            slots[e.offset] = -1;
+        }
+        entries.clear();
+    }
+
+    inline void record(const grid_t<T> &grid, uint32_t at) {
+        if (!recording || at >= GRID_SIZE_TOTAL) {
+            return;
+        }
+
+        if (slots.empty()) {
+            slots.assign(GRID_SIZE_TOTAL, -1);
+        }
+
+        if (slots[at] >= 0) {
+            return;
+        }
+
+        slots[at] = (int32_t)entries.size();
+        entries.push_back({at, grid.items[at]});
+    }
+
+    // for map_grid_and_all() style writes, only tiles the mask actually changes are kept
+    void record_and_all(const grid_t<T> &grid, int mask) {
+        if (!recording) {
+            return;
+        }
+
+        for (uint32_t at = 0; at < GRID_SIZE_TOTAL; ++at) {
+            if (grid.items[at] & ~(T)mask) {
+                record(grid, at);
+            }
+        }
+    }
+
+    void restore(grid_t<T> &grid) {
+        for (const auto &e : entries) {
+            grid.items[e.offset] = e.value;
+            slots[e.offset] = -1;
+        }
+        entries.clear();
+    }
+
+    // restores the tiles accepted by filter, the rest keep their original value in the journal
+    template<typename F>
+    void restore_if(grid_t<T> &grid, F filter) {
+        size_t kept = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const entry_t e = entries[i];
+            if (filter(e.offset)) {
+                grid.items[e.offset] = e.value;
+                slots[e.offset] = -1;
+                continue;
+            }
+
+            slots[e.offset] = (int32_t)kept;
+            entries[kept++] = e;
+        }
+        entries.resize(kept);
+    }
+
+    // rebuilds the full snapshot, the savegame still stores some of the old backup grids
+    void expand(const grid_t<T> &grid, grid_t<T> &snapshot) const {
+        map_grid_copy(grid, snapshot);
+        for (const auto &e : entries) {
+            snapshot.items[e.offset] = e.value;
+        }
+    }
+};
@@ -3,12 +3,13 @@
 #include "graphics/animation.h"
 #include "io/io_buffer.h"
 #include "grid/grid.h"
+#include "grid/grid_journal.h"
 #include "image.h"
 
-grid_xx g_images_grid = {0, FS_UINT32};
-grid_xx g_images_grid_backup = {0, FS_UINT32};
+grid_t<uint32_t> g_images_grid;
+static grid_journal_t<uint32_t> g_images_journal;
 
-grid_xx g_images_alt_grid = {0, FS_UINT32};
+grid_t<uint32_t> g_images_alt_grid;
 
 int map_image_at(int grid_offset) {
     return (int)map_grid_get(g_images_grid, grid_offset);
@@ -19,11 +20,13 @@ int map_image_alt_at(int grid_offset) {
 }
 
 void map_image_set(int grid_offset, int image_id) {
+    g_images_journal.record(g_images_grid, grid_offset);
     map_grid_set(g_images_grid, grid_offset, image_id);
 }
 
 void map_image_set(tile2i tile, const animation_t &anim) {
     int image_id = image_id_from_group(anim.pack, anim.iid) + anim.offset;
+    g_images_journal.record(g_images_grid, tile.grid_offset());
     map_grid_set(g_images_grid, tile.grid_offset(), image_id);
 }
 
@@ -40,13 +43,13 @@ void map_image_alt_set(int grid_offset, int image_id, int alpha) {
 }
 
 void map_image_backup() {
-    map_grid_copy(g_images_grid, g_images_grid_backup);
+    g_images_journal.begin();
 }
 void map_image_restore() {
-    map_grid_copy(g_images_grid_backup, g_images_grid);
+    g_images_journal.restore(g_images_grid);
 }
-void map_image_restore_at(int grid_offset) {
-    map_grid_set(g_images_grid, grid_offset, map_grid_get(g_images_grid_backup, grid_offset));
+void map_image_restore_if(bool (*filter)(int grid_offset)) {
+    g_images_journal.restore_if(g_images_grid, [filter] (uint32_t grid_offset) { return filter(grid_offset); });
 }
 
 void map_image_fix_icorrect_tiles() {
@@ -54,6 +57,7 @@ void map_image_fix_icorrect_tiles() {
 }
 
 void map_image_clear(void) {
+    g_images_journal.stop();
     map_grid_clear(g_images_grid);
     map_grid_clear(g_images_alt_grid);
 }
@@ -31,7 +31,7 @@ void map_image_alt_set(int grid_offset, int image_id, int alpha);
 
 void map_image_backup();
 void map_image_restore();
-void map_image_restore_at(int grid_offset);
+void map_image_restore_if(bool (*filter)(int grid_offset));
 void map_image_fix_icorrect_tiles();
 
 void map_image_clear();
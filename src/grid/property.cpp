@@ -1,6 +1,7 @@
 #include "property.h"
 #include "io/io_buffer.h"
 
+#include "grid/grid_journal.h"
 #include "grid/random.h"
 
 enum e_tile_prop {
@@ -23,11 +24,11 @@ enum e_tile_prop {
     EDGE_NO_NATIVE_LAND = 0x7f,
 };
 
-grid_xx g_edge_grid = {0, FS_UINT8};
-static grid_xx bitfields_grid = {0, FS_UINT8};
+grid_t<uint8_t> g_edge_grid;
+static grid_t<uint8_t> bitfields_grid;
 
-static grid_xx edge_backup = {0, FS_UINT8};
-static grid_xx bitfields_backup = {0, FS_UINT8};
+static grid_journal_t<uint8_t> edge_journal;
+static grid_journal_t<uint8_t> bitfields_journal;
 
 static int edge_for(int x, int y) {
     return 8 * y + x;
@@ -37,9 +38,11 @@ int map_property_is_draw_tile(int grid_offset) {
     return map_grid_get(g_edge_grid, grid_offset) & EDGE_LEFTMOST_TILE;
 }
 void map_property_mark_draw_tile(int grid_offset) {
+    edge_journal.record(g_edge_grid, grid_offset);
     map_grid_or(g_edge_grid, grid_offset, EDGE_LEFTMOST_TILE);
 }
 void map_property_clear_draw_tile(int grid_offset) {
+    edge_journal.record(g_edge_grid, grid_offset);
     map_grid_and(g_edge_grid, grid_offset, ~EDGE_LEFTMOST_TILE);
 }
 int map_property_is_native_land(int grid_offset) {
@@ -47,9 +50,11 @@ int map_property_is_native_land(int grid_offset) {
 }
 
 void map_property_mark_native_land(int grid_offset) {
+    edge_journal.record(g_edge_grid, grid_offset);
     map_grid_or(g_edge_grid, grid_offset, EDGE_NATIVE_LAND);
 }
 void map_property_clear_all_native_land(void) {
+    edge_journal.record_and_all(g_edge_grid, EDGE_NO_NATIVE_LAND);
     map_grid_and_all(g_edge_grid, EDGE_NO_NATIVE_LAND);
 }
 
@@ -67,10 +72,12 @@ int map_property_is_multi_tile_xy(int grid_offset, int x, int y) {
     return (map_grid_get(g_edge_grid, grid_offset) & EDGE_MASK_XY) == edge_for(x, y);
 }
 void map_property_set_multi_tile_xy(int grid_offset, int x, int y, int is_draw_tile) {
+    edge_journal.record(g_edge_grid, grid_offset);
     map_grid_set(g_edge_grid, grid_offset, edge_for(x, y) | (is_draw_tile ? EDGE_LEFTMOST_TILE : 0));
 }
 void map_property_clear_multi_tile_xy(int grid_offset) {
     // only keep native land marker
+    edge_journal.record(g_edge_grid, grid_offset);
     map_grid_and(g_edge_grid, grid_offset, EDGE_NATIVE_LAND);
 }
 int map_property_multi_tile_size(int grid_offset) {
@@ -86,6 +93,7 @@ int map_property_multi_tile_size(int grid_offset) {
 }
 
 void map_property_set_multi_tile_size(int grid_offset, int size) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_and(bitfields_grid, grid_offset, BIT_NO_SIZES);
 
     size = std::clamp(size, 1, 6);
@@ -110,6 +118,7 @@ int map_property_is_alternate_terrain(int grid_offset) {
     return map_grid_get(bitfields_grid, grid_offset) & BIT_ALTERNATE_TERRAIN;
 }
 void map_property_set_alternate_terrain(int grid_offset) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_or(bitfields_grid, grid_offset, BIT_ALTERNATE_TERRAIN);
 }
 
@@ -122,9 +131,11 @@ int map_property_get(int grid_offset) {
 }
 
 void map_property_mark_plaza_or_earthquake(int grid_offset) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_or(bitfields_grid, grid_offset, BIT_PLAZA_OR_EARTHQUAKE);
 }
 void map_property_clear_plaza_or_earthquake(int grid_offset) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_and(bitfields_grid, grid_offset, BIT_NO_PLAZA);
 }
 
@@ -132,10 +143,12 @@ int map_property_is_constructing(int grid_offset) {
     return map_grid_get(bitfields_grid, grid_offset) & BIT_CONSTRUCTION;
 }
 void map_property_mark_constructing(int grid_offset) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_or(bitfields_grid, grid_offset, BIT_CONSTRUCTION);
 }
 
 void map_property_clear_constructing(int grid_offset) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_and(bitfields_grid, grid_offset, BIT_NO_CONSTRUCTION);
 }
 
@@ -144,27 +157,32 @@ int map_property_is_deleted(int grid_offset) {
 }
 
 void map_property_mark_deleted(int grid_offset) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_or(bitfields_grid, grid_offset, BIT_DELETED);
 }
 void map_property_clear_deleted(int grid_offset) {
+    bitfields_journal.record(bitfields_grid, grid_offset);
     map_grid_and(bitfields_grid, grid_offset, BIT_NO_DELETED);
 }
 void map_property_clear_constructing_and_deleted(void) {
+    bitfields_journal.record_and_all(bitfields_grid, BIT_NO_CONSTRUCTION_AND_DELETED);
     map_grid_and_all(bitfields_grid, BIT_NO_CONSTRUCTION_AND_DELETED);
 }
 void map_property_clear(void) {
+    bitfields_journal.stop();
+    edge_journal.stop();
     map_grid_clear(bitfields_grid);
     map_grid_clear(g_edge_grid);
 }
 
 void map_property_backup(void) {
-    map_grid_copy(bitfields_grid, bitfields_backup);
-    map_grid_copy(g_edge_grid, edge_backup);
+    bitfields_journal.begin();
+    edge_journal.begin();
 }
 
 void map_property_restore(void) {
-    map_grid_copy(bitfields_backup, bitfields_grid);
-    map_grid_copy(edge_backup, g_edge_grid);
+    bitfields_journal.restore(bitfields_grid);
+    edge_journal.restore(g_edge_grid);
 }
 
 io_buffer* iob_bitfields_grid = new io_buffer([](io_buffer* iob, size_t version) {
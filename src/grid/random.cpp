@@ -4,7 +4,7 @@
 #include "core/random.h"
 #include "grid/grid.h"
 
-static grid_xx random_xx = {0, FS_UINT8};
+static grid_t<uint8_t> random_xx;
 
 void map_random_clear() {
     map_grid_clear(random_xx);
@@ -1,6 +1,9 @@
 #include "queue.h"
 #include "routing_grids.h"
 
+#include <algorithm>
+#include <vector>
+
 #define GUARD 50000
 
 // static const int ROUTE_OFFSETS[2][8] = {
@@ -42,16 +45,16 @@ struct grid_rounting_t {
 grid_rounting_t g_grid_rounting;
 
 void clear_distances(void) {
-    map_grid_clear(routing_distance);
+    routing_distance.clear();
 }
 
 int valid_offset(int grid_offset) {
-    return map_grid_is_valid_offset(grid_offset) && map_grid_get(routing_distance, grid_offset) == 0
+    return map_grid_is_valid_offset(grid_offset) && routing_distance.get(grid_offset) == 0
            && map_grid_inside_map_area(grid_offset, 1);
 }
 
 void enqueue(int offset, int distance) {
-    map_grid_set(routing_distance, offset, distance);
+    routing_distance.set(offset, distance);
     g_grid_rounting.items[g_grid_rounting.tail++] = offset;
     if (g_grid_rounting.tail >= MAX_QUEUE)
         g_grid_rounting.tail = 0;
@@ -65,7 +68,7 @@ void route_queue(int source, int dest, void (*callback)(int next_offset, int dis
         int offset = queue.items[queue.head];
         if (offset == dest)
             break;
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + routing_distance.get(offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i)))
                 callback(offset + ROUTE_OFFSETS(i), distance);
@@ -81,7 +84,7 @@ void route_queue_until(int source, bool (*callback)(int next_offset, int distanc
     enqueue(source, 1);
     while (queue.head != queue.tail) {
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + routing_distance.get(offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i))) {
                 if (!callback(offset + ROUTE_OFFSETS(i), distance))
@@ -99,7 +102,7 @@ bool route_queue_until_found(int source, tile2i &dst, bool (*callback)(int, int)
     enqueue(source, 1);
     while (queue.head != queue.tail) {
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + routing_distance.get(offset);
         for (int i = 0; i < 4; i++) {
             int next_offset = offset + ROUTE_OFFSETS(i);
             if (valid_offset(next_offset)) {
@@ -122,7 +125,7 @@ bool route_queue_until_terrain(int source, int terrain_type, tile2i* dst, bool (
     enqueue(source, 1);
     while (queue.head != queue.tail) {
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + routing_distance.get(offset);
         for (int i = 0; i < 4; i++) {
             int next_offset = offset + ROUTE_OFFSETS(i);
             if (valid_offset(next_offset)) {
@@ -156,7 +159,7 @@ void route_queue_max(int source, int dest, int max_tiles, void (*callback)(int,
             break;
         if (++tiles > max_tiles)
             break;
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + routing_distance.get(offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i)))
                 callback(offset + ROUTE_OFFSETS(i), distance);
@@ -178,20 +181,20 @@ void route_queue_boat(int source, void (*callback)(int, int)) {
         if (++tiles > GUARD)
             break;
 
-        int drag = map_grid_get(routing_tiles_water, offset) == WATER_N2_MAP_EDGE ? 4 : 0;
-        int v = map_grid_get(water_drag, offset);
+        int drag = routing_tiles_water.get(offset) == WATER_N2_MAP_EDGE ? 4 : 0;
+        int v = water_drag.get(offset);
         if (drag && v < drag) {
             queue.items[queue.tail++] = offset;
             if (queue.tail >= MAX_QUEUE)
                 queue.tail = 0;
         } else {
-            int distance = 1 + map_grid_get(routing_distance, offset);
+            int distance = 1 + routing_distance.get(offset);
             for (int i = 0; i < 4; i++) {
                 if (valid_offset(offset + ROUTE_OFFSETS(i)))
                     callback(offset + ROUTE_OFFSETS(i), distance);
             }
         }
-        map_grid_set(water_drag, offset, v + 1);
+        water_drag.set(offset, v + 1);
         if (++queue.head >= MAX_QUEUE)
             queue.head = 0;
     }
@@ -206,7 +209,7 @@ void route_queue_dir8(int source, void (*callback)(int, int)) {
         if (++tiles > GUARD)
             break;
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + routing_distance.get(offset);
         for (int i = 0; i < 8; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i)))
                 callback(offset + ROUTE_OFFSETS(i), distance);
@@ -216,6 +219,69 @@ void route_queue_dir8(int source, void (*callback)(int, int)) {
     }
 }
 
+struct grid_astar_node_t {
+    int f;
+    int g;
+    int offset;
+
+    // min-heap on f, deeper nodes first on ties so the search runs straight at the target
+    bool operator<(const grid_astar_node_t &o) const { return f != o.f ? f > o.f : g < o.g; }
+};
+
+std::vector<grid_astar_node_t> g_grid_astar_open;
+
+static int astar_heuristic(int offset, int dest, int num_directions) {
+    const int dx = std::abs(GRID_X(offset) - GRID_X(dest));
+    const int dy = std::abs(GRID_Y(offset) - GRID_Y(dest));
+    // diagonal steps cost the same as straight ones in the dir8 flood, so octile degenerates to chebyshev
+    return (num_directions == 8) ? std::max(dx, dy) : (dx + dy);
+}
+
+void route_queue_astar(int source, int dest, int num_directions, int max_tiles, bool (*can_enter)(int next_offset)) {
+    auto &open = g_grid_astar_open;
+    clear_distances();
+    open.clear();
+
+    routing_distance.set(source, 1);
+    open.push_back({1 + astar_heuristic(source, dest, num_directions), 1, source});
+
+    int tiles = 0;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end());
+        const grid_astar_node_t node = open.back();
+        open.pop_back();
+
+        if (node.g != routing_distance.get(node.offset)) {
+            continue; // stale entry, the tile was reached by a shorter path later
+        }
+
+        if (node.offset == dest || ++tiles > max_tiles) {
+            break;
+        }
+
+        const int distance = node.g + 1;
+        for (int i = 0; i < num_directions; i++) {
+            const int next_offset = node.offset + ROUTE_OFFSETS(i);
+            if (!map_grid_is_valid_offset(next_offset) || !map_grid_inside_map_area(next_offset, 1)) {
+                continue;
+            }
+
+            const int next_distance = routing_distance.get(next_offset);
+            if (next_distance != 0 && next_distance <= distance) {
+                continue;
+            }
+
+            if (!can_enter(next_offset)) {
+                continue;
+            }
+
+            routing_distance.set(next_offset, distance);
+            open.push_back({distance + astar_heuristic(next_offset, dest, num_directions), distance, next_offset});
+            std::push_heap(open.begin(), open.end());
+        }
+    }
+}
+
 bool queue_has(int offset) {
     auto &queue = g_grid_rounting;
     for (int i = 0; i < MAX_QUEUE; i++)
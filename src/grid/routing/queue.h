@@ -15,6 +15,7 @@ bool route_queue_until_terrain(int source, int terrain_type, tile2i* dst, bool (
 void route_queue_max(int source, int dest, int max_tiles, void (*callback)(int, int));
 void route_queue_boat(int source, void (*callback)(int, int));
 void route_queue_dir8(int source, void (*callback)(int, int));
+void route_queue_astar(int source, int dest, int num_directions, int max_tiles, bool (*can_enter)(int next_offset));
 
 bool queue_has(int offset);
 int queue_get(int i);
@@ -6,16 +6,20 @@
 #include "building/building.h"
 #include "city/city_buildings.h"
 #include "core/profiler.h"
+#include "core/system_time.h"
+#include "dev/debug.h"
 #include "grid/building.h"
 #include "grid/figure.h"
 #include "grid/grid.h"
 #include "grid/road_canal.h"
 #include "grid/terrain.h"
 #include "grid/water.h"
+#include "scenario/map.h"
 #include "queue.h"
 #include "routing_grids.h"
 
 #include <cmath>
+#include <iomanip>
 
 struct routing_stats_t {
     int total_routes_calculated;
@@ -75,7 +79,7 @@ static bool can_place_on_crossing_no_neighboring(int grid_offset, int terrain_un
 
 static void callback_calc_distance(int next_offset, int dist) {
     OZZY_PROFILER_SECTION("callback_calc_distance");
-    if (map_grid_get(routing_land_citizen, next_offset) >= CITIZEN_0_ROAD)
+    if (routing_land_citizen.get(next_offset) >= CITIZEN_0_ROAD)
         enqueue(next_offset, dist);
 }
 
@@ -84,14 +88,44 @@ void map_routing_calculate_distances(tile2i tile) {
     route_queue(tile.grid_offset(), -1, callback_calc_distance);
 }
 
+// routingbench [iterations]: per-query cost of a land BFS from the city entry versus
+// the number of visited tiles, with the old full-grid clear emulated for comparison
+declare_console_command_p(routingbench) {
+    std::string args; is >> args;
+    const int iterations = std::max(1, atoi(args.empty() ? (pcstr)"100" : args.c_str()));
+    const int source = scenario_map_entry().grid_offset();
+    const int path_lengths[] = {16, 64, 256, 1024, 4096, GRID_SIZE_TOTAL};
+
+    os << "tiles      full_clear(mcs)  generation(mcs)" << std::endl;
+    for (const int max_tiles : path_lengths) {
+        timer full_clear;
+        full_clear.start();
+        for (int i = 0; i < iterations; ++i) {
+            map_grid_clear(routing_distance.distance);
+            route_queue_max(source, -1, max_tiles, callback_calc_distance);
+        }
+        const float full_mcs = float(full_clear.get_elapsed_mcs()) / iterations;
+
+        timer generation;
+        generation.start();
+        for (int i = 0; i < iterations; ++i) {
+            route_queue_max(source, -1, max_tiles, callback_calc_distance);
+        }
+        const float generation_mcs = float(generation.get_elapsed_mcs()) / iterations;
+
+        os << std::setw(10) << std::left << max_tiles << " "
+           << std::setw(16) << full_mcs << " "
+           << generation_mcs << std::endl;
+    }
+}
+
 static void callback_calc_distance_water_boat(int next_offset, int dist) {
-    if (map_grid_get(routing_tiles_water, next_offset) != WATER_N1_BLOCKED
-        && map_grid_get(routing_tiles_water, next_offset) != WATER_N3_LOW_BRIDGE) {
+    if (routing_tiles_water.get(next_offset) != WATER_N1_BLOCKED
+        && routing_tiles_water.get(next_offset) != WATER_N3_LOW_BRIDGE) {
         enqueue(next_offset, dist);
-        if (map_grid_get(routing_tiles_water, next_offset) == WATER_N2_MAP_EDGE) {
-            int v = map_grid_get(routing_distance, next_offset);
-            //            safe_i16(routing_distance)->items[next_offset] += 4;
-            map_grid_set(routing_distance, next_offset, v + 4);
+        if (routing_tiles_water.get(next_offset) == WATER_N2_MAP_EDGE) {
+            int v = routing_distance.get(next_offset);
+            routing_distance.set(next_offset, v + 4);
         }
     }
 }
@@ -106,23 +140,29 @@ void map_routing_calculate_distances_water_boat(tile2i tile) {
     }
 }
 
+static bool can_enter_deepwater(int next_offset) {
+    return routing_tiles_water.get(next_offset) != WATER_N1_BLOCKED
+           && map_terrain_is(next_offset, TERRAIN_DEEPWATER);
+}
+
 static void callback_calc_distance_deepwater(int next_offset, int dist) {
-    if (map_grid_get(routing_tiles_water, next_offset) != WATER_N1_BLOCKED) {
-        if (map_terrain_is(next_offset, TERRAIN_DEEPWATER)) {
-            enqueue(next_offset, dist);
-        }
+    if (can_enter_deepwater(next_offset)) {
+        enqueue(next_offset, dist);
     }
 }
-void map_routing_calculate_distances_deepwater(tile2i tile) {
+
+void map_routing_calculate_distances_deepwater(tile2i tile, tile2i dst) {
     int grid_offset = tile.grid_offset();
     if (map_grid_get(routing_tiles_water, grid_offset) == WATER_N1_BLOCKED) {
         clear_distances();
+    } else if (dst.valid()) {
+        route_queue_astar(grid_offset, dst.grid_offset(), 8, GRID_SIZE_TOTAL, can_enter_deepwater);
     } else {
         route_queue_dir8(grid_offset, callback_calc_distance_deepwater);
     }
 }
 static void callback_calc_distance_build_wall(int next_offset, int dist) {
-    if (map_grid_get(routing_land_citizen, next_offset) == CITIZEN_4_CLEAR_TERRAIN) {
+    if (routing_land_citizen.get(next_offset) == CITIZEN_4_CLEAR_TERRAIN) {
         enqueue(next_offset, dist);
     }
 }
@@ -130,7 +170,7 @@ static void callback_calc_distance_build_road(int next_offset, int dist) {
     bool blocked = false;
     int d_x = MAP_X(next_offset) - MAP_X(queue_get(0));
     int d_y = MAP_Y(next_offset) - MAP_Y(queue_get(0));
-    switch (map_grid_get(routing_land_citizen, next_offset)) {
+    switch (routing_land_citizen.get(next_offset)) {
     case CITIZEN_N3_AQUEDUCT:
         if (!map_can_place_road_under_canal(tile2i(next_offset)))
             blocked = true;
@@ -163,7 +203,7 @@ static void callback_calc_distance_build_aqueduct(int next_offset, int dist) {
     bool blocked = false;
     int d_x = MAP_X(next_offset) - MAP_X(queue_get(0));
     int d_y = MAP_Y(next_offset) - MAP_Y(queue_get(0));
-    switch (map_grid_get(routing_land_citizen, next_offset)) {
+    switch (routing_land_citizen.get(next_offset)) {
     case CITIZEN_0_ROAD: // rubble, garden, access ramp
         if (!map_can_place_canal_on_road(tile2i(next_offset)))
             blocked = true;
@@ -300,7 +340,7 @@ bool map_routing_calculate_distances_for_building(e_routed_mode type, tile2i til
 }
 
 static bool callback_delete_wall_canal(int next_offset, int dist) {
-    if (map_grid_get(routing_land_citizen, next_offset) < CITIZEN_0_ROAD) {
+    if (routing_land_citizen.get(next_offset) < CITIZEN_0_ROAD) {
         if (map_terrain_is(next_offset, TERRAIN_CANAL | TERRAIN_WALL)) {
             map_terrain_remove(next_offset, TERRAIN_CLEARABLE);
             return true;
@@ -333,7 +373,7 @@ static int has_fighting_enemy(int grid_offset) {
 }
 
 static bool callback_travel_found_terrain(int next_offset, int dist, int terrain_type) {
-    if (map_grid_get(routing_land_citizen, next_offset) >= CITIZEN_0_ROAD && !has_fighting_friendly(next_offset)) {
+    if (routing_land_citizen.get(next_offset) >= CITIZEN_0_ROAD && !has_fighting_friendly(next_offset)) {
         enqueue(next_offset, dist);
         if (map_terrain_is(next_offset, terrain_type)) {
             return true;
@@ -349,7 +389,7 @@ bool map_routing_citizen_found_terrain(tile2i src, tile2i *dst, int terrain_type
 }
 
 static bool callback_travel_found_reeds(int next_offset, int dist) {
-    if (map_grid_get(routing_land_citizen, next_offset) >= CITIZEN_0_ROAD && !has_fighting_friendly(next_offset)) {
+    if (routing_land_citizen.get(next_offset) >= CITIZEN_0_ROAD && !has_fighting_friendly(next_offset)) {
         enqueue(next_offset, dist);
         if (map_terrain_is(next_offset, TERRAIN_MARSHLAND)) {
             // requires tile to be fully within a 3x3 marshland area
@@ -369,7 +409,7 @@ bool map_routing_citizen_found_reeds(tile2i src, tile2i &dst) {
 }
 
 static bool callback_travel_found_timber(int next_offset, int dist) {
-    if ((map_grid_get(routing_land_citizen, next_offset) >= CITIZEN_0_ROAD || map_terrain_is(next_offset, TERRAIN_TREE))
+    if ((routing_land_citizen.get(next_offset) >= CITIZEN_0_ROAD || map_terrain_is(next_offset, TERRAIN_TREE))
         && !has_fighting_friendly(next_offset)) {
         enqueue(next_offset, dist);
         if (map_terrain_is(next_offset, TERRAIN_TREE)) {
@@ -386,111 +426,109 @@ bool map_routing_citizen_found_timber(tile2i src, tile2i &dst) {
     return route_queue_until_found(src_offset, dst, callback_travel_found_timber);
 }
 
-static void callback_travel_citizen_land(int next_offset, int dist) {
-    if (map_grid_get(routing_land_citizen, next_offset) >= CITIZEN_0_ROAD 
-        && !has_fighting_friendly(next_offset)
-        && (!map_terrain_is(next_offset, TERRAIN_WATER) || map_terrain_is(next_offset, TERRAIN_FERRY_ROUTE))) {
-        enqueue(next_offset, dist);
+static bool can_enter_citizen_land(int next_offset) {
+    return routing_land_citizen.get(next_offset) >= CITIZEN_0_ROAD
+           && !has_fighting_friendly(next_offset)
+           && (!map_terrain_is(next_offset, TERRAIN_WATER) || map_terrain_is(next_offset, TERRAIN_FERRY_ROUTE));
+}
+
+static bool can_enter_citizen_road(int next_offset) {
+    return routing_land_citizen.get(next_offset) >= CITIZEN_0_ROAD
+           && routing_land_citizen.get(next_offset) < CITIZEN_2_PASSABLE_TERRAIN;
+}
+
+static bool can_enter_citizen_road_garden(int next_offset) {
+    return routing_land_citizen.get(next_offset) >= CITIZEN_0_ROAD
+           && routing_land_citizen.get(next_offset) <= CITIZEN_2_PASSABLE_TERRAIN;
+}
+
+static bool can_enter_walls(int next_offset) {
+    return routing_tiles_walls.get(next_offset) >= WALL_0_PASSABLE
+           && routing_tiles_walls.get(next_offset) <= 2;
+}
+
+static bool can_enter_noncitizen_land_through_building(int next_offset) {
+    if (has_fighting_enemy(next_offset)) {
+        return false;
     }
+
+    return routing_land_noncitizen.get(next_offset) == NONCITIZEN_0_PASSABLE
+           || routing_land_noncitizen.get(next_offset) == NONCITIZEN_2_CLEARABLE
+           || (routing_land_noncitizen.get(next_offset) == NONCITIZEN_1_BUILDING
+               && map_building_at(next_offset) == g_routing_state_data.through_building_id);
 }
 
-bool map_routing_citizen_can_travel_over_land(tile2i src, tile2i dst) {
-    int src_offset = src.grid_offset();
-    int dst_offset = dst.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_citizen_land);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+static bool can_enter_noncitizen_land(int next_offset) {
+    if (has_fighting_enemy(next_offset)) {
+        return false;
+    }
+
+    return routing_land_noncitizen.get(next_offset) >= NONCITIZEN_0_PASSABLE
+           && routing_land_noncitizen.get(next_offset) < NONCITIZEN_5_FORT;
+}
+
+static bool can_enter_noncitizen_through_everything(int next_offset) {
+    return routing_land_noncitizen.get(next_offset) >= NONCITIZEN_0_PASSABLE;
 }
 
-static void callback_travel_citizen_road(int next_offset, int dist) {
-    if (map_grid_get(routing_land_citizen, next_offset) >= CITIZEN_0_ROAD
-        && map_grid_get(routing_land_citizen, next_offset) < CITIZEN_2_PASSABLE_TERRAIN) {
+template<bool (*can_enter)(int)>
+static void callback_travel(int next_offset, int dist) {
+    if (can_enter(next_offset)) {
         enqueue(next_offset, dist);
     }
 }
-bool map_routing_citizen_can_travel_over_road(tile2i src, tile2i dst) {
+
+// goal-directed search when the destination is a real tile, otherwise flood the map as before:
+// some callers pass an invalid destination on purpose and read the distances of the whole area
+template<bool (*can_enter)(int)>
+static bool route_travel(tile2i src, tile2i dst, int max_tiles = GRID_SIZE_TOTAL) {
     int src_offset = src.grid_offset();
     int dst_offset = dst.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_citizen_road);
-    return map_grid_get(routing_distance, dst_offset) != 0;
-}
-
-static void callback_travel_citizen_road_garden(int next_offset, int dist) {
-    if (map_grid_get(routing_land_citizen, next_offset) >= CITIZEN_0_ROAD
-        && map_grid_get(routing_land_citizen, next_offset) <= CITIZEN_2_PASSABLE_TERRAIN) {
-        enqueue(next_offset, dist);
+    if (dst.valid()) {
+        route_queue_astar(src_offset, dst_offset, 4, max_tiles, can_enter);
+    } else if (max_tiles < GRID_SIZE_TOTAL) {
+        route_queue_max(src_offset, dst_offset, max_tiles, callback_travel<can_enter>);
+    } else {
+        route_queue(src_offset, dst_offset, callback_travel<can_enter>);
     }
+
+    return map_routing_distance(dst_offset) != 0;
 }
 
-bool map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int dst_x, int dst_y) {
-    int src_offset = MAP_OFFSET(src_x, src_y);
-    int dst_offset = MAP_OFFSET(dst_x, dst_y);
+bool map_routing_citizen_can_travel_over_land(tile2i src, tile2i dst) {
     ++g_routing_stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_citizen_road_garden);
-    return map_grid_get(routing_distance, dst_offset) != 0;
-}
-static void callback_travel_walls(int next_offset, int dist) {
-    if (map_grid_get(routing_tiles_walls, next_offset) >= WALL_0_PASSABLE
-        && map_grid_get(routing_tiles_walls, next_offset) <= 2) {
-        enqueue(next_offset, dist);
-    }
+    return route_travel<can_enter_citizen_land>(src, dst);
 }
 
-bool map_routing_can_travel_over_walls(int src_x, int src_y, int dst_x, int dst_y) {
-    int src_offset = MAP_OFFSET(src_x, src_y);
-    int dst_offset = MAP_OFFSET(dst_x, dst_y);
+bool map_routing_citizen_can_travel_over_road(tile2i src, tile2i dst) {
     ++g_routing_stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_walls);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return route_travel<can_enter_citizen_road>(src, dst);
 }
 
-static void callback_travel_noncitizen_land_through_building(int next_offset, int dist) {
-    if (!has_fighting_enemy(next_offset)) {
-        if (map_grid_get(routing_land_noncitizen, next_offset) == NONCITIZEN_0_PASSABLE
-            || map_grid_get(routing_land_noncitizen, next_offset) == NONCITIZEN_2_CLEARABLE
-            || (map_grid_get(routing_land_noncitizen, next_offset) == NONCITIZEN_1_BUILDING
-                && map_building_at(next_offset) == g_routing_state_data.through_building_id)) {
-            enqueue(next_offset, dist);
-        }
-    }
+bool map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int dst_x, int dst_y) {
+    ++g_routing_stats.total_routes_calculated;
+    return route_travel<can_enter_citizen_road_garden>(tile2i(src_x, src_y), tile2i(dst_x, dst_y));
 }
 
-static void callback_travel_noncitizen_land(int next_offset, int dist) {
-    if (!has_fighting_enemy(next_offset)) {
-        if (map_grid_get(routing_land_noncitizen, next_offset) >= NONCITIZEN_0_PASSABLE
-            && map_grid_get(routing_land_noncitizen, next_offset) < NONCITIZEN_5_FORT) {
-            enqueue(next_offset, dist);
-        }
-    }
+bool map_routing_can_travel_over_walls(int src_x, int src_y, int dst_x, int dst_y) {
+    ++g_routing_stats.total_routes_calculated;
+    return route_travel<can_enter_walls>(tile2i(src_x, src_y), tile2i(dst_x, dst_y));
 }
 
 bool map_routing_noncitizen_can_travel_over_land(tile2i src, tile2i dst, int only_through_building_id, int max_tiles) {
-    int src_offset = src.grid_offset();
-    int dst_offset = dst.grid_offset();
     ++g_routing_stats.total_routes_calculated;
     ++g_routing_stats.enemy_routes_calculated;
     if (only_through_building_id) {
         g_routing_state_data.through_building_id = only_through_building_id;
-        route_queue(src_offset, dst_offset, callback_travel_noncitizen_land_through_building);
-    } else {
-        route_queue_max(src_offset, dst_offset, max_tiles, callback_travel_noncitizen_land);
+        return route_travel<can_enter_noncitizen_land_through_building>(src, dst);
     }
 
-    return map_grid_get(routing_distance, dst_offset) != 0;
-}
-
-static void callback_travel_noncitizen_through_everything(int next_offset, int dist) {
-    if (map_grid_get(routing_land_noncitizen, next_offset) >= NONCITIZEN_0_PASSABLE)
-        enqueue(next_offset, dist);
+    return route_travel<can_enter_noncitizen_land>(src, dst, max_tiles);
 }
 
 bool map_routing_noncitizen_can_travel_through_everything(tile2i src, tile2i dst) {
-    int src_offset = src.grid_offset();
-    int dst_offset = dst.grid_offset();
     ++g_routing_stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_noncitizen_through_everything);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return route_travel<can_enter_noncitizen_through_everything>(src, dst);
 }
 
 void map_routing_block(int x, int y, int size) {
@@ -499,13 +537,13 @@ void map_routing_block(int x, int y, int size) {
 
     for (int dy = 0; dy < size; dy++) {
         for (int dx = 0; dx < size; dx++) {
-            map_grid_set(routing_distance, MAP_OFFSET(x + dx, y + dy), 0);
+            routing_distance.set(MAP_OFFSET(x + dx, y + dy), 0);
         }
     }
 }
 
 int map_routing_distance(int grid_offset) {
-    return map_grid_get(routing_distance, grid_offset);
+    return map_grid_is_valid_offset(grid_offset) ? routing_distance.get(grid_offset) : 0;
 }
 
 int map_citizen_grid(int grid_offset) {
@@ -13,7 +13,7 @@ enum e_routed_mode {
 
 void map_routing_calculate_distances(tile2i tile);
 void map_routing_calculate_distances_water_boat(tile2i tile);
-void map_routing_calculate_distances_deepwater(tile2i tile);
+void map_routing_calculate_distances_deepwater(tile2i tile, tile2i dst = tile2i::invalid);
 
 bool map_can_place_initial_road_or_canal(int grid_offset, int is_aqueduct);
 bool map_routing_calculate_distances_for_building(e_routed_mode type, tile2i start);
@@ -0,0 +1,59 @@
+#include "routing_cache.h"
+
+#include "core/profiler.h"
+#include "dev/debug.h"
+
+routing_cache_t g_routing_cache;
+
+declare_console_command_p(routecache) {
+    auto &cache = g_routing_cache;
+    const uint32_t total = cache.stats.hits + cache.stats.misses;
+    os << "entries: " << cache.entries.size() << std::endl;
+    os << "hits: " << cache.stats.hits << " misses: " << cache.stats.misses
+       << " (" << (total ? cache.stats.hits * 100 / total : 0) << "% hit)" << std::endl;
+    os << "invalidations: " << cache.stats.invalidations << std::endl;
+}
+
+static uint64_t routing_cache_key(tile2i src, tile2i dst, int terrain_usage) {
+    return (uint64_t(uint32_t(src.grid_offset())) << 32)
+           | (uint64_t(uint16_t(dst.grid_offset())) << 8)
+           | uint64_t(uint8_t(terrain_usage));
+}
+
+const routing_cache_t::path_t *routing_cache_t::find(tile2i src, tile2i dst, int terrain_usage) {
+    if (cached_version != terrain_version) {
+        clear();
+    }
+
+    auto it = entries.find(routing_cache_key(src, dst, terrain_usage));
+    if (it == entries.end()) {
+        ++stats.misses;
+        OZZY_PROFILER_VALUE("Routing cache misses", (int64_t)stats.misses);
+        return nullptr;
+    }
+
+    ++stats.hits;
+    OZZY_PROFILER_VALUE("Routing cache hits", (int64_t)stats.hits);
+    return &it->second;
+}
+
+void routing_cache_t::store(tile2i src, tile2i dst, int terrain_usage, const uint8_t *path, int length) {
+    if (cached_version != terrain_version) {
+        clear();
+    }
+
+    if (entries.size() >= MAX_ENTRIES) {
+        clear();
+    }
+
+    entries[routing_cache_key(src, dst, terrain_usage)].assign(path, path + length);
+}
+
+void routing_cache_t::clear() {
+    if (!entries.empty()) {
+        ++stats.invalidations;
+    }
+
+    entries.clear();
+    cached_version = terrain_version;
+}
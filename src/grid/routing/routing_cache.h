@@ -0,0 +1,34 @@
+#pragma once
+
+#include "grid/point.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// direction paths shared between figures that walk the same (start, destination, terrain usage) route,
+// dropped as a whole whenever the routing terrain changes
+struct routing_cache_t {
+    using path_t = std::vector<uint8_t>;
+
+    struct stats_t {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t invalidations = 0;
+    };
+
+    enum { MAX_ENTRIES = 2048 };
+
+    std::unordered_map<uint64_t, path_t> entries;
+    uint32_t terrain_version = 0;
+    uint32_t cached_version = 0;
+    stats_t stats;
+
+    const path_t *find(tile2i src, tile2i dst, int terrain_usage);
+    void store(tile2i src, tile2i dst, int terrain_usage, const uint8_t *path, int length);
+    void clear();
+
+    inline void terrain_changed() { ++terrain_version; }
+};
+
+extern routing_cache_t g_routing_cache;
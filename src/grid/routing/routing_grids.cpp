@@ -1,9 +1,21 @@
 #include "routing_grids.h"
 
-grid_xx routing_distance = {0, FS_INT16};
-grid_xx water_drag = {0, FS_UINT8};
+routing_distance_grid_t routing_distance;
+grid_t<uint8_t> water_drag;
 
-grid_xx routing_land_citizen = {0, FS_INT8};
-grid_xx routing_land_noncitizen = {0, FS_INT8};
-grid_xx routing_tiles_water = {0, FS_INT8};
-grid_xx routing_tiles_walls = {0, FS_INT8};
+grid_t<int8_t> routing_land_citizen;
+grid_t<int8_t> routing_land_noncitizen;
+grid_t<int8_t> routing_tiles_water;
+grid_t<int8_t> routing_tiles_walls;
+
+void routing_distance_grid_t::clear() {
+    ++generation;
+    if (generation == 0) {
+        clear_full();
+    }
+}
+
+void routing_distance_grid_t::clear_full() {
+    map_grid_clear(stamp);
+    generation = 1;
+}
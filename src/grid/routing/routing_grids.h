@@ -31,10 +31,27 @@ enum {
     NO_VALID_ROUTING_CHECK_RESULT = -99,
 };
 
-extern grid_xx routing_distance;
-extern grid_xx water_drag;
+// BFS distances are only valid for tiles stamped with the current generation,
+// so starting a new query bumps the generation instead of clearing the whole grid
+struct routing_distance_grid_t {
+    grid_t<int16_t> distance;
+    grid_t<uint16_t> stamp;
+    uint16_t generation = 1;
+
+    inline int16_t get(uint32_t at) const { return stamp.items[at] == generation ? distance.items[at] : 0; }
+    inline void set(uint32_t at, int16_t value) {
+        distance.items[at] = value;
+        stamp.items[at] = generation;
+    }
+
+    void clear();
+    void clear_full();
+};
+
+extern routing_distance_grid_t routing_distance;
+extern grid_t<uint8_t> water_drag;
 
-extern grid_xx routing_land_citizen;
-extern grid_xx routing_land_noncitizen;
-extern grid_xx routing_tiles_water;
-extern grid_xx routing_tiles_walls;
\ No newline at end of file
+extern grid_t<int8_t> routing_land_citizen;
+extern grid_t<int8_t> routing_land_noncitizen;
+extern grid_t<int8_t> routing_tiles_water;
+extern grid_t<int8_t> routing_tiles_walls;
\ No newline at end of file
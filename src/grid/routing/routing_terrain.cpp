@@ -3,8 +3,10 @@
 #include "building/building.h"
 #include "building/monuments.h"
 #include "core/direction.h"
+#include "core/log.h"
 #include "core/profiler.h"
 #include "core/svector.h"
+#include "dev/debug.h"
 #include "graphics/image.h"
 #include "graphics/image_groups.h"
 #include "graphics/view/view.h"
@@ -16,11 +18,57 @@
 #include "grid/terrain.h"
 #include "grid/water.h"
 #include "routing_grids.h"
+#include "routing_cache.h"
 #include "routing.h"
 #include "scenario/map.h"
 #include "figure/route.h"
 #include "city/city_buildings.h"
 
+#include <algorithm>
+
+// bounding box (in grid coordinates) of tiles whose terrain or building changed
+// since the last land routing update, only this area plus a 1-tile margin gets rechecked
+struct routing_land_dirty_t {
+    enum e_mode {
+        MODE_FULL,
+        MODE_INCREMENTAL,
+        MODE_VERIFY,
+    };
+
+    e_mode mode = MODE_INCREMENTAL;
+    bool full = true;
+    bool any = false;
+    int min_x = 0;
+    int min_y = 0;
+    int max_x = 0;
+    int max_y = 0;
+
+    void mark(int grid_offset);
+    void reset();
+    int verify();
+};
+
+routing_land_dirty_t g_routing_land_dirty;
+
+declare_console_command_p(routingland) {
+    std::string args; is >> args;
+
+    auto &dirty = g_routing_land_dirty;
+    if (args == "full") {
+        dirty.mode = routing_land_dirty_t::MODE_FULL;
+    } else if (args == "incremental") {
+        dirty.mode = routing_land_dirty_t::MODE_INCREMENTAL;
+    } else if (args == "verify") {
+        dirty.mode = routing_land_dirty_t::MODE_VERIFY;
+    } else if (args == "check") {
+        os << "mismatched tiles: " << dirty.verify() << std::endl;
+        return;
+    }
+
+    pcstr modes[] = {"full", "incremental", "verify"};
+    os << "land routing update mode: " << modes[dirty.mode] << std::endl;
+}
+
 static int get_land_type_citizen_building(int grid_offset) {
     building* b = building_at(grid_offset);
     switch (b->type) {
@@ -286,6 +334,8 @@ int map_routing_tile_check(int routing_type, int grid_offset) {
 
 void map_routing_update_land_citizen(void) {
     OZZY_PROFILER_SECTION("Game/Run/Routing/Update land/Citizen");
+    // cached routes only cover citizen terrain usages
+    g_routing_cache.terrain_changed();
     map_grid_fill(routing_land_citizen, -1);
     int grid_offset = scenario_map_data()->start_offset;
     for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
@@ -351,10 +401,114 @@ static void map_routing_update_land_noncitizen(void) {
     }
 }
 
+void routing_land_dirty_t::mark(int grid_offset) {
+    const int x = GRID_X(grid_offset);
+    const int y = GRID_Y(grid_offset);
+    if (!any) {
+        any = true;
+        min_x = max_x = x;
+        min_y = max_y = y;
+        return;
+    }
+
+    min_x = std::min(min_x, x);
+    max_x = std::max(max_x, x);
+    min_y = std::min(min_y, y);
+    max_y = std::max(max_y, y);
+}
+
+void routing_land_dirty_t::reset() {
+    full = false;
+    any = false;
+}
+
+int routing_land_dirty_t::verify() {
+    int mismatches = 0;
+    int grid_offset = scenario_map_data()->start_offset;
+    for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
+        for (int x = 0; x < scenario_map_data()->width; x++, grid_offset++) {
+            const int citizen = map_routing_tile_check(ROUTING_TYPE_CITIZEN, grid_offset);
+            const int noncitizen = map_routing_tile_check(ROUTING_TYPE_NONCITIZEN, grid_offset);
+            if (citizen == map_grid_get(routing_land_citizen, grid_offset)
+                && noncitizen == map_grid_get(routing_land_noncitizen, grid_offset)) {
+                continue;
+            }
+
+            if (!mismatches) {
+                logs::warn("routing: land grids differ from the full rebuild at %d,%d (%d/%d != %d/%d)", x, y,
+                           map_grid_get(routing_land_citizen, grid_offset), map_grid_get(routing_land_noncitizen, grid_offset),
+                           citizen, noncitizen);
+            }
+            map_grid_set(routing_land_citizen, grid_offset, citizen);
+            map_grid_set(routing_land_noncitizen, grid_offset, noncitizen);
+            ++mismatches;
+        }
+    }
+
+    if (mismatches) {
+        g_routing_cache.terrain_changed();
+        logs::warn("routing: %d land tiles differ from the full rebuild", mismatches);
+    }
+    return mismatches;
+}
+
+void map_routing_mark_land_dirty(int grid_offset) {
+    g_routing_land_dirty.mark(grid_offset);
+}
+
+void map_routing_mark_land_dirty_all() {
+    g_routing_land_dirty.full = true;
+}
+
+static void map_routing_update_land_area(int min_x, int min_y, int max_x, int max_y) {
+    OZZY_PROFILER_SECTION("Game/Run/Routing/Update land/Area");
+    bool citizen_changed = false;
+    for (int y = min_y; y <= max_y; y++) {
+        int grid_offset = GRID_OFFSET(min_x, y);
+        for (int x = min_x; x <= max_x; x++, grid_offset++) {
+            const int citizen = map_routing_tile_check(ROUTING_TYPE_CITIZEN, grid_offset);
+            citizen_changed |= (citizen != map_grid_get(routing_land_citizen, grid_offset));
+            map_grid_set(routing_land_citizen, grid_offset, citizen);
+            map_grid_set(routing_land_noncitizen, grid_offset, map_routing_tile_check(ROUTING_TYPE_NONCITIZEN, grid_offset));
+        }
+    }
+
+    if (citizen_changed) {
+        g_routing_cache.terrain_changed();
+    }
+}
+
 void map_routing_update_land() {
     OZZY_PROFILER_SECTION("Game/Run/Routing/Update land");
-    map_routing_update_land_citizen();
-    map_routing_update_land_noncitizen();
+    auto &dirty = g_routing_land_dirty;
+    if (dirty.full || dirty.mode == routing_land_dirty_t::MODE_FULL) {
+        // tile checks may fix broken building tiles and mark them dirty again, so reset first
+        dirty.reset();
+        map_routing_update_land_citizen();
+        map_routing_update_land_noncitizen();
+        return;
+    }
+
+    if (dirty.any) {
+        const int map_min_x = GRID_X(scenario_map_data()->start_offset);
+        const int map_min_y = GRID_Y(scenario_map_data()->start_offset);
+        const int map_max_x = map_min_x + scenario_map_data()->width - 1;
+        const int map_max_y = map_min_y + scenario_map_data()->height - 1;
+
+        const int min_x = std::max(dirty.min_x - 1, map_min_x);
+        const int min_y = std::max(dirty.min_y - 1, map_min_y);
+        const int max_x = std::min(dirty.max_x + 1, map_max_x);
+        const int max_y = std::min(dirty.max_y + 1, map_max_y);
+        dirty.reset();
+
+        if (min_x <= max_x && min_y <= max_y) {
+            map_routing_update_land_area(min_x, min_y, max_x, max_y);
+        }
+    }
+
+    if (dirty.mode == routing_land_dirty_t::MODE_VERIFY) {
+        dirty.verify();
+    }
 }
 
 void map_routing_update_ferry_routes() {
@@ -460,6 +614,7 @@ void map_routing_update_walls(void) {
 }
 
 void map_routing_update_all(void) {
+    map_routing_mark_land_dirty_all();
     map_routing_update_land();
     map_routing_update_water();
     map_routing_update_walls();
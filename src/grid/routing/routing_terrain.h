@@ -16,6 +16,11 @@ void map_routing_update_water(void);
 void map_routing_update_walls(void);
 void map_routing_update_ferry_routes();
 
+// terrain and building grid edits record the touched tiles, map_routing_update_land() then
+// only rechecks that area unless a full rebuild was requested
+void map_routing_mark_land_dirty(int grid_offset);
+void map_routing_mark_land_dirty_all();
+
 bool map_routing_passable_by_usage(int terrain_usage, int grid_offset);
 
 int map_routing_citizen_is_passable(int grid_offset);
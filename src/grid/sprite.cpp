@@ -2,29 +2,34 @@
 #include "io/io_buffer.h"
 
 #include "grid/grid.h"
+#include "grid/grid_journal.h"
 
-grid_xx g_sprite_grid = {0, FS_UINT8};
-grid_xx g_sprite_grid_backup = {0, FS_UINT8};
+grid_t<uint8_t> g_sprite_grid;
+grid_t<uint8_t> g_sprite_grid_backup;
+static grid_journal_t<uint8_t> g_sprite_journal;
 
 int map_sprite_animation_at(int grid_offset) {
     return map_grid_get(g_sprite_grid, grid_offset);
 }
 void map_sprite_animation_set(int grid_offset, int value) {
+    g_sprite_journal.record(g_sprite_grid, grid_offset);
     map_grid_set(g_sprite_grid, grid_offset, value);
 }
 
 void map_sprite_clear_tile(int grid_offset) {
+    g_sprite_journal.record(g_sprite_grid, grid_offset);
     map_grid_set(g_sprite_grid, grid_offset, 0);
 }
 void map_sprite_clear(void) {
+    g_sprite_journal.stop();
     map_grid_clear(g_sprite_grid);
 }
 
 void map_sprite_backup(void) {
-    map_grid_copy(g_sprite_grid, g_sprite_grid_backup);
+    g_sprite_journal.begin();
 }
 void map_sprite_restore(void) {
-    map_grid_copy(g_sprite_grid_backup, g_sprite_grid);
+    g_sprite_journal.restore(g_sprite_grid);
 }
 
 io_buffer* iob_sprite_grid = new io_buffer([](io_buffer* iob, size_t version) {
@@ -32,5 +37,6 @@ io_buffer* iob_sprite_grid = new io_buffer([](io_buffer* iob, size_t version) {
 });
 
 io_buffer* iob_sprite_backup_grid = new io_buffer([](io_buffer* iob, size_t version) {
+    g_sprite_journal.expand(g_sprite_grid, g_sprite_grid_backup);
     iob->bind(BIND_SIGNATURE_GRID, &g_sprite_grid_backup);
 });
\ No newline at end of file
@@ -4,15 +4,18 @@
 #include "city/city_floods.h"
 #include "floodplain.h"
 #include "grid/grid.h"
+#include "grid/grid_journal.h"
 #include "grid/ring.h"
 #include "grid/trees.h"
 #include "grid/routing/routing.h"
+#include "grid/routing/routing_terrain.h"
 #include "scenario/map.h"
+#include "widget/widget_minimap.h"
 #include "vegetation.h"
 #include "water.h"
 
-grid_xx g_terrain_grid = {0, FS_UINT32};
-grid_xx g_terrain_grid_backup = {0, FS_UINT32};
+grid_t<uint32_t> g_terrain_grid;
+static grid_journal_t<uint32_t> g_terrain_journal;
 
 bool map_terrain_is(int grid_offset, int terrain_mask) {
     return map_grid_is_valid_offset(grid_offset) && !!(map_grid_get(g_terrain_grid, grid_offset) & terrain_mask);
@@ -30,16 +33,35 @@ bool map_terrain_is_near_ferry_route(int base_offset, int radius) {
     return false;
 }
 
+// terrain bits read by the land routing tile checks
+constexpr int TERRAIN_ROUTING_LAND = TERRAIN_NOT_CLEAR | TERRAIN_FERRY_ROUTE;
+
+static void map_terrain_changed(int grid_offset, int changed) {
+    if (changed & TERRAIN_ROUTING_LAND) {
+        map_routing_mark_land_dirty(grid_offset);
+    }
+
+    if (changed) {
+        widget_minimap_mark_tile(grid_offset);
+    }
+}
+
 int map_terrain_get(int grid_offset) {
     return map_grid_get(g_terrain_grid, grid_offset);
 }
 void map_terrain_set(int grid_offset, int terrain) {
+    map_terrain_changed(grid_offset, map_grid_get(g_terrain_grid, grid_offset) ^ terrain);
+    g_terrain_journal.record(g_terrain_grid, grid_offset);
     map_grid_set(g_terrain_grid, grid_offset, terrain);
 }
 void map_terrain_add(int grid_offset, int terrain) {
+    map_terrain_changed(grid_offset, terrain & ~map_grid_get(g_terrain_grid, grid_offset));
+    g_terrain_journal.record(g_terrain_grid, grid_offset);
     map_grid_or(g_terrain_grid, grid_offset, terrain);
 }
 void map_terrain_remove(int grid_offset, int terrain) {
+    map_terrain_changed(grid_offset, terrain & map_grid_get(g_terrain_grid, grid_offset));
+    g_terrain_journal.record(g_terrain_grid, grid_offset);
     map_grid_and(g_terrain_grid, grid_offset, ~terrain);
 }
 
@@ -67,6 +89,11 @@ void map_terrain_remove_with_radius(tile2i c, int size, int radius, int terrain)
 }
 
 void map_terrain_remove_all(int terrain) {
+    if (terrain & TERRAIN_ROUTING_LAND) {
+        map_routing_mark_land_dirty_all();
+    }
+    widget_minimap_invalidate();
+    g_terrain_journal.record_and_all(g_terrain_grid, ~terrain);
     map_grid_and_all(g_terrain_grid, ~terrain);
 }
 
@@ -368,13 +395,20 @@ void map_terrain_add_triumphal_arch_roads(int x, int y, int orientation) {
 /////
 
 void map_terrain_backup(void) {
-    map_grid_copy(g_terrain_grid, g_terrain_grid_backup);
+    g_terrain_journal.begin();
 }
 void map_terrain_restore(void) {
-    map_grid_copy(g_terrain_grid_backup, g_terrain_grid);
+    for (const auto &e : g_terrain_journal.entries) {
+        map_routing_mark_land_dirty(e.offset);
+        widget_minimap_mark_tile(e.offset);
+    }
+    g_terrain_journal.restore(g_terrain_grid);
 }
 void map_terrain_clear(void) {
+    g_terrain_journal.stop();
     map_grid_clear(g_terrain_grid);
+    map_routing_mark_land_dirty_all();
+    widget_minimap_invalidate();
 }
 void map_terrain_init_outside_map(void) {
     int map_width = scenario_map_data()->width;
@@ -420,13 +454,13 @@ void build_terrain_caches() {
 }
 
 // unknown data grid
-static grid_xx GRID03_32BIT = {0, FS_INT32}; // ?? routing
+static grid_t<int32_t> GRID03_32BIT; // ?? routing
 int map_get_UNK03(int grid_offset) {
     return map_grid_get(GRID03_32BIT, grid_offset);
 }
 
 // unknown data grid
-static grid_xx GRID04_8BIT = {0, FS_INT8};
+static grid_t<int8_t> GRID04_8BIT;
 int map_get_UNK04(int grid_offset) {
     return map_grid_get(GRID04_8BIT, grid_offset);
 }
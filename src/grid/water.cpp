@@ -1,5 +1,6 @@
 #include "water.h"
 
+#include "core/random.h"
 #include "building/building.h"
 #include "graphics/view/view.h"
 #include "grid/building.h"
@@ -270,7 +271,7 @@ water_dest map_water_find_alternative_fishing_boat_tile(figure &boat) {
         }
     });
 
-    tile2i result = tiles.empty() ? tile2i::invalid : tiles[rand() % tiles.size()];
+    tile2i result = tiles.empty() ? tile2i::invalid : tiles[random_sim_between(0, tiles.size())];
     return { result.valid(), 0, result };
 }
 
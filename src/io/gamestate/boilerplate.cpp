@@ -49,6 +49,7 @@
 #include "grid/floodplain.h"
 #include "grid/water.h"
 #include "game/game.h"
+#include "game/game_events.h"
 #include "content/vfs.h"
 #include "scenario/criteria.h"
 #include "scenario/demand_change.h"
@@ -596,6 +597,39 @@ bool GamestateIO::write_savegame(pcstr filename_short) {
     return save_ok;
 }
 
+void GamestateIO::bind_savegame_state(std::function<void(pcstr name, const buffer &buf)> visit) {
+    FILEIO.bind_state(FILE_FORMAT_SAVE_FILE_EXT, latest_save_version, file_schema, visit);
+}
+
+static vfs::path g_async_save_path;
+
+bool GamestateIO::write_savegame_async(pcstr filename_short) {
+    vfs::path full = fullpath_saves(filename_short);
+    e_file_format format = get_format_from_file(filename_short);
+    assert(format == FILE_FORMAT_SAVE_FILE_EXT);
+
+    // skipped and logged by the manager while the previous write is still running
+    const bool started = FILEIO.serialize_async(full, 0, format, latest_save_version, file_schema, [] (bool ok) {
+        events::emit(event_savegame_written{ ok });
+    });
+
+    // the written event is handled on this thread, never before we get here
+    if (started) {
+        g_async_save_path = full;
+    }
+    return started;
+}
+
+void GamestateIO::on_savegame_written(bool ok) {
+    if (!ok) {
+        return;
+    }
+
+    game_features::gameopt_last_save_filename = g_async_save_path.c_str();
+    game_features::gameopt_last_player = g_settings.player_name.c_str();
+    game_features::save();
+}
+
 bool GamestateIO::write_map(const char* filename_short) {
     return false; // TODO
 
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include "content/dir.h"
 
+class buffer;
+
 // file versions found so far:
 //  144 (Bridges.map only)
 //  146 (NAFTA.map and Warfare.map only)
@@ -17,6 +20,9 @@
 //  165 akhenaten: save house health option
 constexpr uint32_t latest_save_version = 166;
 
+// posted once a background savegame write finishes
+struct event_savegame_written { bool ok; };
+
 vfs::path fullpath_saves(const char* filename);
 void fullpath_maps(char* full, const char* filename);
 
@@ -26,9 +32,14 @@ const int read_file_version(const char* filename, int offset);
 
 bool write_mission(const int scenario_id);
 bool write_savegame(const char* filename_short);
+bool write_savegame_async(const char* filename_short);
+void on_savegame_written(bool ok);
 
 bool write_map(const char* filename_short);
 
+// runs the savegame schema over the current state in memory, visit gets every chunk by name
+void bind_savegame_state(std::function<void(pcstr name, const buffer &buf)> visit);
+
 bool load_mission(const int scenario_id, bool start_immediately);
 bool load_savegame(pcstr filename_short, bool start_immediately = true);
 bool load_map(pcstr filename_short, bool start_immediately = true);
@@ -3,6 +3,9 @@
 #include "content/vfs.h"
 #include "platform/platform.h"
 
+#include <algorithm>
+#include <cstring>
+
 int io_read_sgx_entries_num(vfs::path filepath) {
     vfs::path fs_file = vfs::content_file(filepath);
     if (fs_file.empty()) {
@@ -42,25 +45,19 @@ int io_read_file_into_buffer(vfs::path filepath, int localizable, buffer* buf, i
         return 0;
     }
 
-    FILE* fp = vfs::file_open_os(fs_file, "rb");
-    if (!fp) {
+    // mapped when the platform allows it, so the only copy is the one into buf
+    vfs::reader file = vfs::file_open(fs_file);
+    if (!file) {
         return 0;
     }
 
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    if (size > max_size) {
-        size = max_size;
-    }
-
+    int size = std::min(file->size(), max_size);
     if (size > buf->size()) {
         return 0;
     }
 
-    fseek(fp, 0, SEEK_SET);
-    int bytes_read = buf->from_file((size_t)size, fp);
-    vfs::file_close(fp);
-    return bytes_read;
+    memcpy(buf->data_unsafe_pls_use_carefully(), file->data(), size);
+    return size;
 }
 
 int io_read_file_part_into_buffer(vfs::path  filepath, int localizable, buffer* buf, int size, int offset_in_file) {
@@ -118,7 +118,8 @@ public:
         bind(BIND_SIGNATURE_UINT16, tile.private_access(_Y));        // 58
     }
 
-    void bind(bind_signature_e signature, grid_xx *ext) {
+    template <typename T>
+    void bind(bind_signature_e signature, grid_t<T> *ext) {
         if (signature == BIND_SIGNATURE_GRID) {
             IO_BRANCH(map_grid_load_buffer(*ext, p_buf), map_grid_save_buffer(*ext, p_buf))
         }
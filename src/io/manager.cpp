@@ -1,11 +1,15 @@
 #include "manager.h"
 #include "core/string.h"
 #include "core/log.h"
+#include "core/profiler.h"
 #include "core/zip.h"
+#include "core/threading.h"
+#include "game/game.h"
 #include "io/gamestate/boilerplate.h"
 #include "platform/platform.h"
 
 #include <cinttypes>
+#include <memory>
 #include <string.h>
 
 #define COMPRESS_BUFFER_SIZE 3000000
@@ -109,8 +113,28 @@ static void log_hex(file_chunk_t* chunk, int i, int offs, int num_chunks) {
                fname);
 }
 
-static char compress_buffer[COMPRESS_BUFFER_SIZE];
-static bool read_compressed_chunk(FILE* fp, buffer* buf, int filepiece_size) {
+// compressed chunks are packed/unpacked on the game.mt pool, the file itself is still read and written in order
+struct chunk_packing_t {
+    uint32_t header = 0;         // compressed size, or UNCOMPRESSED
+    std::vector<uint8_t> packed; // compressed bytes as stored in the file
+    bool ok = true;
+};
+
+template<typename F>
+static void run_chunk_jobs(int count, F &job) {
+    // a save issued from a pool worker must not wait on its own pool
+    if (count <= 1 || threading::this_thread::get_pool() == &game.mt) {
+        for (int i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    auto futures = game.mt.submit_sequence(0, count, job);
+    futures.wait();
+}
+
+static bool read_compressed_chunk(FILE* fp, buffer* buf, int filepiece_size, chunk_packing_t &packing) {
     // check that the stream size isn't above maximum temp buffer
     if (filepiece_size > COMPRESS_BUFFER_SIZE)
         return false;
@@ -118,48 +142,70 @@ static bool read_compressed_chunk(FILE* fp, buffer* buf, int filepiece_size) {
     // read 32-bit int header denoting size of compressed chunk
     uint32_t chunk_size = 0;
     fread(&chunk_size, 4, 1, fp);
+    packing.header = chunk_size;
 
     // if file signature says "uncompressed" well man, it's uncompressed. read as normal ignoring the directive
     if ((unsigned int)chunk_size == UNCOMPRESSED) {
         if (buf->from_file(filepiece_size, fp) != filepiece_size)
             return false;
     } else {
+        if (chunk_size > COMPRESS_BUFFER_SIZE) {
+            logs::info("Incorrect chunk size, %u is above maximum", chunk_size);
+            return false;
+        }
+
         // read into buffer chunk of specified size - the actual "file piece" size is used for the output!
-        size_t csize = fread(compress_buffer, 1, chunk_size, fp);
+        packing.packed.resize(chunk_size);
+        size_t csize = fread(packing.packed.data(), 1, chunk_size, fp);
         if (csize != chunk_size) {
             logs::info("Incorrect chunk size, expected %i, found %i", chunk_size, csize);
             return false;
         }
-        int bsize = zip_decompress(compress_buffer, chunk_size, buf->data_unsafe_pls_use_carefully(), &filepiece_size);
-        if (bsize != buf->size()) {
-            logs::info("Incorrect buffer size, expected %u, found %i", buf->size(), bsize);
-            return false;
-        }
-        //        if (fread(compress_buffer, 1, chunk_size, fp) != chunk_size
-        //            || zip_decompress(compress_buffer, chunk_size, buf->data_unsafe_pls_use_carefully(),
-        //            &filepiece_size) !=
-        //               buf->size())
-        //            return 0;
     }
-    //    buf->force_validate_unsafe_pls_use_carefully();
 
     return true;
 }
-static bool write_compressed_chunk(FILE* fp, buffer* buf, int bytes_to_write) {
+
+static bool unpack_chunk(buffer* buf, int filepiece_size, chunk_packing_t &packing) {
+    if (packing.header == UNCOMPRESSED) {
+        return true;
+    }
+
+    int bsize = zip_decompress(packing.packed.data(), (int)packing.packed.size(), buf->data_unsafe_pls_use_carefully(), &filepiece_size);
+    packing.packed = {};
+    if (bsize != buf->size()) {
+        logs::info("Incorrect buffer size, expected %u, found %i", buf->size(), bsize);
+        return false;
+    }
+
+    return true;
+}
+
+static bool pack_chunk(const uint8_t* data, int bytes_to_write, chunk_packing_t &packing) {
     if (bytes_to_write > COMPRESS_BUFFER_SIZE)
         return false;
 
+    thread_local std::vector<uint8_t> compress_buffer;
+    compress_buffer.resize(COMPRESS_BUFFER_SIZE);
+
     int output_size = COMPRESS_BUFFER_SIZE;
-    if (zip_compress(buf->get_data(), bytes_to_write, compress_buffer, &output_size)) {
-        //        write_int32(fp, output_size);
-        fwrite(&output_size, 4, 1, fp);
-        fwrite(compress_buffer, 1, output_size, fp);
+    if (zip_compress(data, bytes_to_write, compress_buffer.data(), &output_size)) {
+        packing.header = output_size;
+        packing.packed.assign(compress_buffer.begin(), compress_buffer.begin() + output_size);
     } else {
         // unable to compress: write uncompressed
-        //        write_int32(fp, UNCOMPRESSED);
-        output_size = UNCOMPRESSED;
-        fwrite(&output_size, 4, 1, fp);
-        fwrite(buf->get_data(), 1, bytes_to_write, fp);
+        packing.header = UNCOMPRESSED;
+        packing.packed.clear();
+    }
+    return true;
+}
+
+static bool write_compressed_chunk(FILE* fp, const uint8_t* data, int bytes_to_write, const chunk_packing_t &packing) {
+    fwrite(&packing.header, 4, 1, fp);
+    if (packing.header == UNCOMPRESSED) {
+        fwrite(data, 1, bytes_to_write, fp);
+    } else {
+        fwrite(packing.packed.data(), 1, packing.packed.size(), fp);
     }
     return true;
 }
@@ -207,13 +253,23 @@ bool FileIOManager::serialize(const char* filename, int offset, e_file_format fo
             file_chunks.at(i).iob->write();
     }
 
+    // compress chunks
+    std::vector<chunk_packing_t> packings(num_chunks());
+    auto pack = [this, &packings] (int i) {
+        file_chunk_t* chunk = &file_chunks.at(i);
+        if (chunk->compressed) {
+            packings[i].ok = pack_chunk(chunk->buf->get_data(), (int)chunk->buf->size(), packings[i]);
+        }
+    };
+    run_chunk_jobs(num_chunks(), pack);
+
     // serialize chunks to disk
     for (int i = 0; i < num_chunks(); i++) {
         file_chunk_t* chunk = &file_chunks.at(i);
 
         int result = 0;
         if (chunk->compressed) {
-            result = write_compressed_chunk(fp, chunk->buf, chunk->buf->size());
+            result = packings[i].ok && write_compressed_chunk(fp, chunk->buf->get_data(), chunk->buf->size(), packings[i]);
         } else {
             result = chunk->buf->to_file(chunk->buf->size(), fp);
         }
@@ -238,6 +294,131 @@ bool FileIOManager::serialize(const char* filename, int offset, e_file_format fo
     return true;
 }
 
+struct file_snapshot_t {
+    struct chunk_t {
+        bool compressed;
+        std::vector<uint8_t> data;
+    };
+
+    vfs::path fs_path;
+    int offset;
+    int version;
+    std::vector<chunk_t> chunks;
+};
+
+static bool write_snapshot(file_snapshot_t &snapshot) {
+    OZZY_PROFILER_SECTION("Game/Autosave/Write");
+    FILE* fp = vfs::file_open_os(snapshot.fs_path, "wb");
+    if (!fp) {
+        logs::error("Unable to write file %s, file could not be accessed.", snapshot.fs_path.c_str());
+        return false;
+    } else if (snapshot.offset) {
+        fseek(fp, snapshot.offset, SEEK_SET);
+    }
+
+    bool ok = true;
+    for (auto &chunk : snapshot.chunks) {
+        const int size = (int)chunk.data.size();
+        if (chunk.compressed) {
+            chunk_packing_t packing;
+            ok = pack_chunk(chunk.data.data(), size, packing) && write_compressed_chunk(fp, chunk.data.data(), size, packing);
+        } else {
+            ok = fwrite(chunk.data.data(), 1, size, fp) == size;
+        }
+
+        if (!ok) {
+            logs::error("Unable to write file %s, write failure.", snapshot.fs_path.c_str());
+            break;
+        }
+    }
+
+    vfs::file_close(fp);
+    vfs::sync_em_fs();
+
+    if (ok) {
+        logs::info("File write successful: %s %i@ --- VERSION: %i ---", snapshot.fs_path.c_str(), snapshot.offset, snapshot.version);
+    }
+    return ok;
+}
+
+bool FileIOManager::serialize_async(pcstr filename, int offset, e_file_format format, const int version, void (*init_schema)(e_file_format _format, const int _version), void (*on_done)(bool ok)) {
+    bool expected = false;
+    if (!async_write_running.compare_exchange_strong(expected, true)) {
+        logs::info("Skipping write of %s, previous background write is still running", filename);
+        return false;
+    }
+
+    auto snapshot = std::make_shared<file_snapshot_t>();
+    {
+        OZZY_PROFILER_SECTION("Game/Autosave/Snapshot");
+        clear();
+        strncpy_safe(file_path, filename, MAX_FILE_NAME);
+        file_offset = offset;
+        file_format = format;
+        file_version = version;
+
+        if (init_schema == nullptr) {
+            async_write_running = false;
+            return io_failure_cleanup("write", "provided schema is invalid");
+        }
+        init_schema(file_format, file_version);
+
+        // bind game state on the calling thread, after this the chunk buffers are free for the next save or load
+        snapshot->fs_path = vfs::content_path(file_path);
+        snapshot->offset = file_offset;
+        snapshot->version = file_version;
+        snapshot->chunks.resize(num_chunks());
+        for (int i = 0; i < num_chunks(); ++i) {
+            file_chunk_t &chunk = file_chunks.at(i);
+            if (chunk.VALID) {
+                chunk.iob->write();
+            }
+
+            const uint8_t *data = chunk.buf->get_data();
+            snapshot->chunks[i].compressed = chunk.compressed;
+            snapshot->chunks[i].data.assign(data, data + chunk.buf->size());
+        }
+    }
+
+    game.mt.detach_task([this, snapshot, on_done] () {
+        const bool ok = write_snapshot(*snapshot);
+        async_write_running = false;
+        if (on_done) {
+            on_done(ok);
+        }
+    });
+
+    return true;
+}
+
+void FileIOManager::wait_async_write() const {
+    if (async_write_running) {
+        logs::info("Waiting for the background write of %s", file_path);
+    }
+
+    while (async_write_running) {
+        SDL_Delay(1);
+    }
+}
+
+void FileIOManager::bind_state(e_file_format format, const int version, void (*init_schema)(e_file_format _format, const int _version), std::function<void(pcstr name, const buffer &buf)> visit) {
+    OZZY_PROFILER_SECTION("Game/BindState");
+    clear();
+    file_format = format;
+    file_version = version;
+    init_schema(file_format, file_version);
+
+    for (int i = 0; i < num_chunks(); ++i) {
+        file_chunk_t &chunk = file_chunks.at(i);
+        if (!chunk.VALID) {
+            continue;
+        }
+
+        chunk.iob->write();
+        visit(chunk.name, *chunk.buf);
+    }
+}
+
 bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format,
                                 const int (*determine_file_version)(pcstr fnm, int ofst),
                                 void (*init_schema)(e_file_format _format, const int _version)) {
@@ -280,18 +461,18 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
     }
 
     // read file contents into buffers
+    std::vector<chunk_packing_t> packings(num_chunks());
+    std::vector<long> offsets(num_chunks());
     for (int i = 0; i < num_chunks(); i++) {
         file_chunk_t* chunk = &file_chunks.at(i);
-        findex = i;
-        fname = chunk->name;
-
-        long offs = ftell(fp);
+        offsets[i] = ftell(fp);
 
         bool result = false;
         if (chunk->compressed) {
-            result = read_compressed_chunk(fp, chunk->buf, chunk->buf->size());
+            result = read_compressed_chunk(fp, chunk->buf, chunk->buf->size(), packings[i]);
             if (!result) {
                 logs::error("Unable to read file[%s] chunk[%s], decompression failed.", fs_path.c_str(), chunk->name);
+                vfs::file_close(fp);
                 clear();
                 return false;
             }
@@ -302,22 +483,44 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
             if (!result) {
                 logs::info("Incorrect buffer size, expected %i, found %i", exp, got);
                 logs::error("Unable to read file [%s], chunk size incorrect.", fs_path.c_str());
+                vfs::file_close(fp);
                 clear();
                 return false;
             }
         }
+    }
+
+    // close file handle
+    vfs::file_close(fp);
+
+    // decompress chunks
+    auto unpack = [this, &packings] (int i) {
+        file_chunk_t* chunk = &file_chunks.at(i);
+        if (chunk->compressed) {
+            packings[i].ok = unpack_chunk(chunk->buf, (int)chunk->buf->size(), packings[i]);
+        }
+    };
+    run_chunk_jobs(num_chunks(), unpack);
+
+    for (int i = 0; i < num_chunks(); i++) {
+        file_chunk_t* chunk = &file_chunks.at(i);
+        findex = i;
+        fname = chunk->name;
+
+        if (!packings[i].ok) {
+            logs::error("Unable to read file[%s] chunk[%s], decompression failed.", fs_path.c_str(), chunk->name);
+            clear();
+            return false;
+        }
 
         // ******** DEBUGGING ********
         export_unzipped(chunk); // export uncompressed buffer data to zip folder
         if (true) {
-            log_hex(chunk, i, offs, num_chunks()); // print full chunk read log info
+            log_hex(chunk, i, offsets[i], num_chunks()); // print full chunk read log info
         }
         // ***************************
     }
 
-    // close file handle
-    vfs::file_close(fp);
-
     // load GAME STATE from buffers
     for (int i = 0; i < num_chunks(); ++i) {
         if (file_chunks.at(i).VALID) {
@@ -5,6 +5,8 @@
 #include "content/file_formats.h"
 #include "io/io_buffer.h"
 
+#include <atomic>
+#include <functional>
 #include <vector>
 
 struct file_chunk_t {
@@ -44,6 +46,7 @@ private:
 
     std::vector<file_chunk_t> file_chunks;
     int alloc_index = 0;
+    std::atomic<bool> async_write_running = false;
 
     void clear();
     bool io_failure_cleanup(const char* action, const char* reason); // because I'm anal about reusing code...
@@ -61,6 +64,14 @@ public:
 
     // write/read internal chunk cache (io_buffer sequence) to/from disk file
     bool serialize(const char* filename, int offset, e_file_format format, const int version, void (*init_schema)(e_file_format _format, const int _version));
+    // binds the game state into a snapshot on the calling thread, then compresses and writes it on game.mt;
+    // on_done runs on the worker. fails without writing while a previous background write is still running
+    bool serialize_async(pcstr filename, int offset, e_file_format format, const int version, void (*init_schema)(e_file_format _format, const int _version), void (*on_done)(bool ok));
+    bool async_write_pending() const { return async_write_running; }
+    // blocks until the background write started by serialize_async is on disk
+    void wait_async_write() const;
+    // binds the game state into the chunk buffers without touching disk and hands every chunk to visit
+    void bind_state(e_file_format format, const int version, void (*init_schema)(e_file_format _format, const int _version), std::function<void(pcstr name, const buffer &buf)> visit);
     bool unserialize(pcstr filename, int offset, e_file_format format, const int (*determine_file_version)(pcstr _filename, int _offset),
                      void (*init_schema)(e_file_format _format, const int _version));
 };
@@ -1,6 +1,8 @@
 #include "js.h"
 
 #include "content/dir.h"
+#include "core/archive_snapshot.h"
+#include "core/crc32.h"
 #include "core/log.h"
 #include "graphics/window.h"
 #include "js/js_constants.h"
@@ -8,13 +10,17 @@
 #include "js/js_folder_notifier.h"
 #include "js/js_game.h"
 #include "graphics/elements/panel.h"
+#include "graphics/screen.h"
 #include "mujs/mujs.h"
 #include "mujs/jsi.h"
 #include "mujs/jsvalue.h"
 #include "platform/arguments.h"
 #include "platform/platform.h"
+#include "platform/version.hpp"
 
+#include <cstring>
 #include <filesystem>
+#include <unordered_map>
 
 #define MAX_FILES_RELOAD 255
 
@@ -25,9 +31,14 @@ struct {
     int have_error;
     bstring256 error_str;
     js_State *J;
+    archive_snapshot snapshot;
+    bool snapshot_refresh; // config came from the snapshot, the first sync only runs the readers
+    bool snapshot_capture; // scripts loaded until the first sync make up a new snapshot
+    bool refreshed;        // config handlers ran over this vm at least once
 } vm;
 
 void js_reset_vm_state();
+static void js_vm_boot();
 
 int js_vm_trypcall(js_State *J, int params) {
     if (vm.have_error) {
@@ -59,14 +70,10 @@ int js_vm_trypcall(js_State *J, int params) {
     return 1;
 }
 
-int js_vm_load_file_and_exec(pcstr path) {
-    if (!path || !*path) {
-        return 0;
-    }
-
+static vfs::reader js_vm_open_script(pcstr path, vfs::path &rpath) {
     pcstr npath = (*path == ':') ? (path + 1) : path;
 
-    vfs::path rpath = path;
+    rpath = path;
     if (!vm.scripts_folders.empty()) {
         rpath = js_vm_get_absolute_path(npath);
     } 
@@ -75,14 +82,29 @@ int js_vm_load_file_and_exec(pcstr path) {
     if (!reader) {
         reader = vfs::file_open(path, "rt");
     }
+    return reader;
+}
 
+int js_vm_load_file_and_exec(pcstr path) {
+    if (!path || !*path) {
+        return 0;
+    }
+
+    vfs::path rpath;
+    vfs::reader reader = js_vm_open_script(path, rpath);
     if (!reader) {
+        if (vm.snapshot_capture) {
+            vm.snapshot.sources.push_back({path, "", 0});
+        }
         logs::info("!!! Cant find script at %s", rpath.c_str());
         return 0;
     }
 
     const uint32_t fsize = reader->size();
     std::string data = (char *)reader->data();
+    if (vm.snapshot_capture) {
+        vm.snapshot.sources.push_back({path, rpath.c_str(), crc32(data.data(), (uint32_t)data.size())});
+    }
 
     int error = js_ploadstring(vm.J, rpath, data.c_str());
     if (error) {
@@ -101,18 +123,131 @@ int js_vm_load_file_and_exec(pcstr path) {
 }
 
 js_State *js_vm_state() {
+    if (!vm.J && archive_snapshot::active) {
+        js_vm_boot();
+    }
     return vm.J;
 }
 
+static vfs::path js_vm_snapshot_path() {
+    return vfs::content_path("config.cache");
+}
+
+// the snapshot is only used while every script it was made from resolves to the same file with the same content
+static bool js_vm_snapshot_load() {
+    auto &snapshot = vm.snapshot;
+    if (!snapshot.load(js_vm_snapshot_path())) {
+        return false;
+    }
+
+    if (snapshot.version != get_version().c_str() || snapshot.screen.x != screen_width() || snapshot.screen.y != screen_height()) {
+        return false;
+    }
+
+    for (const auto &source : snapshot.sources) {
+        vfs::path rpath;
+        vfs::reader reader = js_vm_open_script(source.requested.c_str(), rpath);
+        if (!reader || source.resolved.empty()) {
+            if (!!reader || !source.resolved.empty()) {
+                return false;
+            }
+            continue;
+        }
+
+        std::string data = (char *)reader->data();
+        if (source.resolved != rpath.c_str() || crc32(data.data(), (uint32_t)data.size()) != source.crc) {
+            return false;
+        }
+    }
+
+    return !snapshot.sources.empty();
+}
+
+static void js_vm_snapshot_save() {
+    auto &snapshot = vm.snapshot;
+    snapshot.version = get_version().c_str();
+    snapshot.screen = {screen_width(), screen_height()};
+    snapshot.capture(vm.J);
+
+    vfs::path path = js_vm_snapshot_path();
+    if (snapshot.save(path)) {
+        logs::info("JS: config snapshot saved to %s (%u scripts, %u values)", path.c_str(), (uint32_t)snapshot.sources.size(), (uint32_t)snapshot.nodes.size());
+    }
+    snapshot = {};
+}
+
+// the vm starts on first demand when the config came from the snapshot: settings writes,
+// config::load() and script reloads need it. the snapshot stays readable for the readers
+// that still hold it, writes made on it go over to the vm
+static void js_vm_boot() {
+    std::vector<vfs::path> pending(vm.files2load, vm.files2load + vm.files2load_num);
+
+    js_reset_vm_state();
+    for (int i = 0; i < vm.files2load_num; i++) {
+        js_vm_load_file_and_exec(vm.files2load[i]);
+    }
+
+    for (int i = 0; i < MAX_FILES_RELOAD; ++i) {
+        vm.files2load[i].clear();
+    }
+    vm.files2load_num = 0;
+    for (const auto &path : pending) {
+        js_vm_reload_file(path);
+    }
+
+    if (g_config_arch.state == &vm.snapshot) {
+        g_config_arch.state = vm.J;
+    }
+    vm.snapshot.replay(g_config_arch);
+    logs::info("JS: vm started over the config snapshot");
+}
+
+using js_globals_t = std::unordered_map<std::string, js_Value>;
+
+static js_globals_t js_vm_globals() {
+    js_globals_t globals;
+    for (js_Property *p = vm.J->G->head; p; p = p->next) {
+        globals[p->name] = p->value;
+    }
+    return globals;
+}
+
+// globals a reload assigned: a re-executed `var section = {...}` always gets a new object
+static std::vector<xstring> js_vm_changed_globals(const js_globals_t &before) {
+    std::vector<xstring> changed;
+    for (js_Property *p = vm.J->G->head; p; p = p->next) {
+        auto it = before.find(p->name);
+        if (it == before.end() || memcmp(&it->second, &p->value, sizeof(js_Value)) != 0) {
+            changed.push_back(p->name);
+        }
+    }
+    return changed;
+}
+
 bool js_vm_sync() {
+    if (vm.snapshot_refresh) {
+        vm.snapshot_refresh = false;
+        config::refresh(&vm.snapshot);
+        return true;
+    }
+
     if (!vm.files2load_num) {
         return false;
     }
 
+    // a running vm only re-executes the changed files, so only the sections they assign need reading again
+    bool partial = vm.refreshed && vm.J && !vm.have_error;
+    if (!vm.J) {
+        js_vm_boot();
+    }
+
     if (vm.have_error) {
+        vm.snapshot_capture = false;
         js_reset_vm_state();
     }
 
+    const js_globals_t before = partial ? js_vm_globals() : js_globals_t{};
+
     if (vm.files2load_num > 0) {
         for (int i = 0; i < vm.files2load_num; i++) {
             logs::info("JS: script reloaded %s", vm.files2load[i].c_str());
@@ -124,10 +259,24 @@ bool js_vm_sync() {
         vm.files2load[i].clear();
     }
 
-    config::refresh(vm.J);
+    if (vm.snapshot_capture) {
+        vm.snapshot_capture = false;
+        if (!vm.have_error) {
+            js_vm_snapshot_save();
+        }
+    }
+
+    const std::vector<xstring> changed = partial ? js_vm_changed_globals(before) : std::vector<xstring>{};
+    if (partial && !vm.have_error && !changed.empty()) {
+        config::refresh(vm.J, changed);
+    } else {
+        // errors, a first load, or a file that only mutated existing objects
+        config::refresh(vm.J);
+    }
 
     vm.files2load_num = 0;
     vm.have_error = 0;
+    vm.refreshed = true;
     return true;
 }
 
@@ -309,7 +458,15 @@ vfs::path js_vm_get_absolute_path(vfs::path path) {
 
 void js_vm_setup() {
     vm.J = nullptr;
-    js_reset_vm_state();
+    if (g_args.use_config_cache() && js_vm_snapshot_load()) {
+        logs::info("JS: scripts are unchanged, config is read from the snapshot");
+        archive_snapshot::active = &vm.snapshot;
+        vm.snapshot_refresh = true;
+    } else {
+        vm.snapshot = {};
+        vm.snapshot_capture = g_args.use_config_cache();
+        js_reset_vm_state();
+    }
 
     vfs::path abspath = js_vm_get_absolute_path("");
     vfs::path modules_file(abspath, "/modules.js");
@@ -18,6 +18,8 @@
 
 #include "js.h"
 
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 g_archive g_config_arch{nullptr};
@@ -89,14 +91,62 @@ void js_register_game_functions(js_State *J) {
     //REGISTER_GLOBAL_FUNCTION(J, js_game_set_image, "set_image", 1);
 }
 
+// sections every handler read on its last run, handlers without an entry did not run yet
+static std::unordered_map<const config::ArchiveIterator *, std::vector<xstring>> g_config_reads;
+static config::refresh_scope_t g_config_scope;
+
+static void config_run_handler(const config::ArchiveIterator *s) {
+    auto &reads = g_config_reads[s];
+    reads.clear();
+    g_archive::reads = &reads;
+    s->func();
+    g_archive::reads = nullptr;
+}
+
+bool config::refresh_scope_t::affects(pcstr section) const {
+    if (all) {
+        return true;
+    }
+
+    return section && std::find(sections.begin(), sections.end(), section) != sections.end();
+}
+
+const config::refresh_scope_t &config::refresh_scope() {
+    return g_config_scope;
+}
+
 void config::refresh(archive arch) {
     g_config_arch = {arch.state};
+    g_config_scope = {};
     animation_t::global_hashtime = game.frame;
     for (ArchiveIterator *s = ArchiveIterator::tail; s; s = s->next) {
-        s->func();
+        config_run_handler(s);
     }
 }
 
+void config::refresh(archive arch, const std::vector<xstring> &sections) {
+    g_config_arch = {arch.state};
+    g_config_scope = {false, sections};
+    animation_t::global_hashtime = game.frame;
+
+    int handlers = 0;
+    for (ArchiveIterator *s = ArchiveIterator::tail; s; s = s->next) {
+        auto it = g_config_reads.find(s);
+        const bool depends = (it == g_config_reads.end())
+                                || std::any_of(it->second.begin(), it->second.end(), [&] (const xstring &section) {
+                                       return std::find(sections.begin(), sections.end(), section) != sections.end();
+                                   });
+        if (!depends) {
+            continue;
+        }
+
+        config_run_handler(s);
+        ++handlers;
+    }
+
+    logs::info("config: %u sections changed, %d handlers reloaded", (uint32_t)sections.size(), handlers);
+}
+
 archive config::load(pcstr filename) {
     vfs::path fspath = vfs::content_path(filename);
     js_vm_load_file_and_exec(fspath);
@@ -16,7 +16,17 @@ void js_register_game_objects(js_State *J);
 
 namespace config {
 
+// top level sections the last refresh re-read, everything after a full refresh
+struct refresh_scope_t {
+    bool all = true;
+    std::vector<xstring> sections;
+
+    bool affects(pcstr section) const;
+};
+
 void refresh(archive);
+void refresh(archive, const std::vector<xstring> &sections); // only the handlers that read one of the sections
+const refresh_scope_t &refresh_scope();
 archive load(pcstr filename);
 
 using config_iterator_function_cb = void ();
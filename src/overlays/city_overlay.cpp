@@ -43,6 +43,7 @@ void config_load_city_overlays() {
 
         overlay->buildings = arch.r_array_num<e_building_type>("buildings");
         overlay->walkers = arch.r_array_num<e_figure_type>("walkers");
+        overlay->update_type_sets();
         overlay->column_type = arch.r_type<e_column_type>("column_type");
         overlay->tooltips = arch.r_array_num("tooltips");
         overlay->caption = arch.r_string("caption");
@@ -50,6 +51,22 @@ void config_load_city_overlays() {
     });
 }
 
+// column values only move with the simulation, but drawing asks for them every frame for every
+// visible building. entries are valid for one sim tick and for the building type they were taken for
+struct overlay_column_cache_t {
+    struct entry_t {
+        int stamp = 0;
+        e_building_type type = BUILDING_NONE;
+        int height = COLUMN_TYPE_NONE;
+        e_column_color color = COLUMN_COLOR_NONE;
+    };
+
+    const city_overlay *owner = nullptr;
+    std::vector<entry_t> entries;
+};
+
+overlay_column_cache_t g_overlay_column_cache;
+
 city_overlay* city_overlay::get(e_overlay ov) {
     if (ov < 0 || ov >= OVERLAY_SIZE) {
         return nullptr;
@@ -231,8 +248,49 @@ city_overlay::city_overlay(e_overlay t) : type(t) {
     overlays()[type] = this;
 }
 
+void city_overlay::update_type_sets() {
+    buildings_set.reset();
+    for (e_building_type type : buildings) {
+        if (type >= 0 && type < BUILDING_MAX) {
+            buildings_set.set(type);
+        }
+    }
+
+    walkers_set.reset();
+    for (e_figure_type type : walkers) {
+        if (type >= 0 && type < FIGURE_MAX) {
+            walkers_set.set(type);
+        }
+    }
+}
+
+int city_overlay::cached_column(const building *b, e_column_color &color) const {
+    auto &cache = g_overlay_column_cache;
+    if (cache.owner != this) {
+        cache.owner = this;
+        cache.entries.clear();
+    }
+
+    if (b->id >= cache.entries.size()) {
+        cache.entries.resize(b->id + 1);
+    }
+
+    // +1 keeps the stamp of the very first tick apart from empty entries
+    const int stamp = game.simtime.absolute_tick(true) + 1;
+    auto &entry = cache.entries[b->id];
+    if (entry.stamp != stamp || entry.type != b->type) {
+        entry.stamp = stamp;
+        entry.type = b->type;
+        entry.height = get_column_height(b);
+        entry.color = get_column_color(b);
+    }
+
+    color = entry.color;
+    return entry.height;
+}
+
 bool city_overlay::show_figure(const figure *f) const {
-    return std::find(walkers.begin(), walkers.end(), f->type) != walkers.end();
+    return f->type >= 0 && f->type < FIGURE_MAX && walkers_set.test(f->type);
 }
 
 void city_overlay::draw_custom_top(vec2i pixel, tile2i tile, painter &ctx) const {
@@ -246,7 +304,7 @@ void city_overlay::draw_custom_top(vec2i pixel, tile2i tile, painter &ctx) const
 }
 
 bool city_overlay::show_building(const building *b) const {
-    return std::find(buildings.begin(), buildings.end(), b->type) != buildings.end();
+    return b->type >= 0 && b->type < BUILDING_MAX && buildings_set.test(b->type);
 }
 
 void city_overlay::draw_building_top(vec2i pixel, tile2i tile, painter &ctx) const {
@@ -258,8 +316,8 @@ void city_overlay::draw_building_top(vec2i pixel, tile2i tile, painter &ctx) con
         return;
     }
 
-    int column_height = get_column_height(b);
-    e_column_color column_color = get_column_color(b);
+    e_column_color column_color;
+    int column_height = cached_column(b, column_color);
     if (column_height == COLUMN_TYPE_NONE) {
         return;
     }
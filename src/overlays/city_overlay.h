@@ -8,6 +8,8 @@
 #include "core/svector.h"
 #include "core/tokenum.h"
 
+#include <bitset>
+
 extern const token_holder<e_overlay, OVERLAY_NONE, OVERLAY_SIZE> e_overlay_tokens;
 extern const token_holder<e_column_type, COLUMN_TYPE_RISK, COLUMN_TYPE_SIZE> e_column_type_tokens;
 
@@ -23,6 +25,8 @@ struct city_overlay {
     svector<int, 10> tooltips;
     svector<e_figure_type, 10> walkers;
     svector<e_building_type, 10> buildings;
+    std::bitset<FIGURE_MAX> walkers_set;      // walkers compiled for show_figure()
+    std::bitset<BUILDING_MAX> buildings_set;  // buildings compiled for show_building()
     e_column_type column_type = COLUMN_TYPE_NONE;
     animation_t anim;
 
@@ -43,6 +47,8 @@ struct city_overlay {
     virtual void draw_building_top(vec2i pixel, tile2i tile, painter &ctx) const;
 
     xstring title() const;
+    void update_type_sets();
+    int cached_column(const building *b, e_column_color &color) const;
     void draw_overlay_column(e_column_color c, vec2i pixel, int height, int column_style, painter &ctx) const;
     void draw_building_footprint(painter &ctx, vec2i pos, tile2i tile, int image_offset) const;
     bool is_drawable_farm_corner(tile2i tile) const;
@@ -8,6 +8,7 @@
 #include "js/js_game.h"
 #include "core/profiler.h"
 #include "game/game.h"
+#include "game/headless.h"
 #include "game/system.h"
 #include "graphics/screen.h"
 #include "input/mouse.h"
@@ -621,11 +622,26 @@ static void main_loop() {
 int main(int argc, char** argv) {
     g_args.parse(argc, argv);
 
+    if (g_args.is_headless()) {
+        // offscreen window and software renderer, image paks still need a renderer to upload into
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+        g_args.set_use_sound(false);
+        g_args.set_window_mode(true);
+        g_args.set_renderer("software");
+    }
+
     crashhandler_install();
 
     logs::initialize();
 
     setup();
+
+    if (g_args.is_headless()) {
+        const int result = game_headless_run(g_args.get_headless_save(), g_args.get_headless_ticks(), g_args.get_headless_record(), g_args.get_headless_compare());
+        teardown();
+        return result;
+    }
     g_mouse.init();
     
     game_imgui_overlay_init();
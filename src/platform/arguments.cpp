@@ -22,6 +22,9 @@
 #define CURSOR_SCALE_ERROR_MESSAGE "Option --cursor-scale must be followed by a scale value of 1, 1.5 or 2"
 #define DISPLAY_SCALE_ERROR_MESSAGE "Option --display-scale must be followed by a scale value between 0.5 and 5"
 #define MIXED_MODE_ERROR_MESSAGE "Option --mixed should have path to script folder"
+#define HEADLESS_ERROR_MESSAGE "Option --headless should have savegame name"
+#define TICKS_ERROR_MESSAGE "Option --ticks must be followed by a positive number of ticks"
+#define DIGEST_ERROR_MESSAGE "Options --record and --compare should have a file name"
 #define UNKNOWN_OPTION_ERROR_MESSAGE "Option %s not recognized"
 
 Arguments g_args;
@@ -236,6 +239,16 @@ char const* Arguments::usage() {
            "         create full dump on crash\n"
            "  --logjsfiles\n"
            "         print logs which files open with js\n"
+           "  --configcache\n"
+           "         keep evaluated scripts in config.cache and skip them while the scripts are unchanged\n"
+           "  --headless SAVEGAME\n"
+           "         load SAVEGAME, run the simulation without window or sound and log timings\n"
+           "  --ticks NUMBER\n"
+           "         number of ticks for --headless run (default is one game year)\n"
+           "  --record FILE\n"
+           "         write the state digest of every --headless tick to FILE\n"
+           "  --compare FILE\n"
+           "         check every --headless tick against a digest FILE and report the first divergence\n"
            "\n"
            "The last argument, if present, is interpreted as data directory of the Pharaoh installation";
 }
@@ -328,6 +341,8 @@ void Arguments::parse_cli_(int argc, char** argv) {
             window_mode_ = true;
         } else if (SDL_strcmp(argv[i], "--logjsfiles") == 0) {
             logjsfiles_ = true;
+        } else if (SDL_strcmp(argv[i], "--configcache") == 0) {
+            config_cache_ = true;
         } else if (SDL_strcmp(argv[i], "--nosound") == 0) {
             use_sound_ = false;
         } else if (SDL_strcmp(argv[i], "--nocrashdlg") == 0) {
@@ -364,6 +379,33 @@ void Arguments::parse_cli_(int argc, char** argv) {
                 app_terminate(DISPLAY_SCALE_ERROR_MESSAGE);
             }
 
+        } else if (SDL_strcmp(argv[i], "--headless") == 0) {
+            if (i + 1 < argc) {
+                headless_save_ = argv[i + 1];
+                ++i;
+            } else {
+                app_terminate(HEADLESS_ERROR_MESSAGE);
+            }
+
+        } else if (SDL_strcmp(argv[i], "--ticks") == 0) {
+            if (i + 1 < argc) {
+                headless_ticks_ = SDL_strtol(argv[i + 1], nullptr, 10);
+                ++i;
+            }
+
+            if (headless_ticks_ <= 0) {
+                app_terminate(TICKS_ERROR_MESSAGE);
+            }
+
+        } else if (SDL_strcmp(argv[i], "--record") == 0 || SDL_strcmp(argv[i], "--compare") == 0) {
+            if (i + 1 < argc) {
+                auto &digest_file = (SDL_strcmp(argv[i], "--record") == 0) ? headless_record_ : headless_compare_;
+                digest_file = argv[i + 1];
+                ++i;
+            } else {
+                app_terminate(DIGEST_ERROR_MESSAGE);
+            }
+
         } else if (SDL_strcmp(argv[i], "--cursor-scale") == 0) {
             if (i + 1 < argc) {
                 int percentage = parse_decimal_as_percentage(argv[i + 1]);
@@ -17,6 +17,7 @@ public:
     void set_window_mode(bool flag = true);
 
     [[nodiscard]] bool is_logjsfiles() const { return logjsfiles_; }
+    [[nodiscard]] bool use_config_cache() const { return config_cache_; }
 
     [[nodiscard]] int get_display_scale_percentage() const;
     void set_display_scale_percentage(int value);
@@ -36,6 +37,12 @@ public:
     [[nodiscard]] bool use_crashdlg() const { return use_crashdlg_; }
     [[nodiscard]] bool create_fulldmp() const { return create_fulldmp_; }
 
+    [[nodiscard]] bool is_headless() const { return !headless_save_.empty(); }
+    [[nodiscard]] pcstr get_headless_save() const { return headless_save_.c_str(); }
+    [[nodiscard]] int get_headless_ticks() const { return headless_ticks_; }
+    [[nodiscard]] pcstr get_headless_record() const { return headless_record_.c_str(); }
+    [[nodiscard]] pcstr get_headless_compare() const { return headless_compare_.c_str(); }
+
     [[nodiscard]] const char* get_scripts_directory() const;
     void parse(int argc, char **argv);
 
@@ -44,6 +51,10 @@ private:
     vfs::path scripts_directory_;
 
     bstring64 renderer_;
+    bstring256 headless_save_;
+    bstring256 headless_record_;
+    bstring256 headless_compare_;
+    int headless_ticks_ = 9600; // one game year
     int display_scale_percentage_ = 100;
     int cursor_scale_percentage_ = 100;
     vec2i window_size_ = {800, 600};
@@ -52,6 +63,7 @@ private:
     bool use_crashdlg_ = true;
     bool create_fulldmp_ = false;
     bool logjsfiles_ = false;
+    bool config_cache_ = false;
 
     /// apply parameters from command line
     void parse_cli_(int argc, char** argv);
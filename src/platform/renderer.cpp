@@ -8,6 +8,7 @@
 #include "platform/screen.h"
 #include "platform/platform.h"
 #include "graphics/image_groups.h"
+#include "graphics/sprite_batch.h"
 #include "graphics/view/view.h"
 #include "game/game.h"
 #include "input/cursor.h"
@@ -122,11 +123,13 @@ graphics_renderer_interface g_render;
 renderer_data_t g_renderer_data;
 
 bool graphics_renderer_interface::save_screen_buffer(painter &ctx, color* pixels, int x, int y, int width, int height, int row_width) {
+    g_sprite_batch.flush();
     SDL_Rect rect = {x, y, width, height};
     return SDL_RenderReadPixels(ctx.renderer, &rect, SDL_PIXELFORMAT_ARGB8888, pixels, row_width * sizeof(color)) == 0;
 }
 
 void graphics_renderer_interface::draw_line(vec2i start, vec2i end, color color) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_SetRenderDrawColor(data.renderer,
                            (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
@@ -137,6 +140,7 @@ void graphics_renderer_interface::draw_line(vec2i start, vec2i end, color color)
 }
 
 void graphics_renderer_interface::draw_pixel(vec2i pixel, color color) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_SetRenderDrawColor(data.renderer,
                            (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
@@ -146,6 +150,7 @@ void graphics_renderer_interface::draw_pixel(vec2i pixel, color color) {
     SDL_RenderDrawPoint(data.renderer, pixel.x, pixel.y);
 }
 void graphics_renderer_interface::draw_rect(vec2i start, vec2i size, color color) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_SetRenderDrawColor(data.renderer,
                            (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
@@ -157,6 +162,7 @@ void graphics_renderer_interface::draw_rect(vec2i start, vec2i size, color color
 }
 
 void graphics_renderer_interface::fill_rect(vec2i start, vec2i size, color color) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_SetRenderDrawColor(data.renderer,
                            (color & COLOR_CHANNEL_RED) >> COLOR_BITSHIFT_RED,
@@ -168,24 +174,28 @@ void graphics_renderer_interface::fill_rect(vec2i start, vec2i size, color color
 }
 
 void graphics_renderer_interface::clear_screen(void) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_SetRenderDrawColor(data.renderer, 0, 0, 0, 0xff);
     SDL_RenderClear(data.renderer);
 }
 
 void graphics_renderer_interface::set_viewport(int x, int y, int width, int height) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_Rect viewport = {x, y, width, height};
     SDL_RenderSetViewport(data.renderer, &viewport);
 }
 
 void graphics_renderer_interface::reset_viewport(void) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_RenderSetViewport(data.renderer, NULL);
     SDL_RenderSetClipRect(data.renderer, NULL);
 }
 
 void graphics_renderer_interface::set_clip_rectangle(vec2i pos, int width, int height) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_Rect clip = {pos.x, pos.y, width, height};
     SDL_RenderSetClipRect(data.renderer, &clip);
@@ -212,6 +222,7 @@ rect graphics_renderer_interface::clip_rectangle() {
 }
 
 void graphics_renderer_interface::reset_clip_rectangle(void) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_RenderSetClipRect(data.renderer, NULL);
 }
@@ -329,6 +340,7 @@ void graphics_renderer_interface::draw_image_grayscale(painter &ctx, const image
 }
 
 void graphics_renderer_interface::create_custom_texture(int type, int width, int height) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     if (data.custom_textures[type].texture) {
         SDL_DestroyTexture(data.custom_textures[type].texture);
@@ -349,6 +361,7 @@ void graphics_renderer_interface::create_custom_texture(int type, int width, int
     SDL_SetTextureBlendMode(data.custom_textures[type].texture, SDL_BLENDMODE_BLEND);
 }
 color* graphics_renderer_interface::get_custom_texture_buffer(int type, int* actual_texture_width) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     if (!data.custom_textures[type].texture) {
         return 0;
@@ -387,6 +400,7 @@ void graphics_renderer_interface::release_custom_texture_buffer(int type) {
 }
 
 void graphics_renderer_interface::update_custom_texture(int type) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
 #ifndef __vita__
     if (!data.custom_textures[type].texture || !data.custom_textures[type].buffer) {
@@ -406,6 +420,7 @@ SDL_Texture* graphics_renderer_interface::get_custom_texture(int type) {
 void graphics_renderer_interface::update_custom_texture_from(int type, const color *buffer,
     int x_offset, int y_offset, int width, int height)
 {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     if (game.paused || !data.custom_textures[type].texture) {
         return;
@@ -432,6 +447,7 @@ void graphics_renderer_interface::update_custom_texture_from(int type, const col
 }
 
 void graphics_renderer_interface::update_custom_texture_yuv(int type, const uint8_t* y_data, int y_width, const uint8_t* cb_data, int cb_width, const uint8_t* cr_data, int cr_width) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
 #ifdef USE_YUV_TEXTURES
     if (!data.supports_yuv_textures || !data.custom_textures[type].texture) {
@@ -460,6 +476,7 @@ static buffer_texture* get_saved_texture_info(int texture_id) {
 }
 
 int graphics_renderer_interface::save_texture_from_screen(int texture_id, vec2i pos, int width, int height) {
+    g_sprite_batch.flush();
     assert(width > 0 && height > 0);
 
     auto &data = g_renderer_data;
@@ -512,6 +529,7 @@ int graphics_renderer_interface::save_texture_from_screen(int texture_id, vec2i
 }
 
 void graphics_renderer_interface::delete_saved_texture(int image_id) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
 
     auto it = std::find_if(data.texture_buffers.begin(), data.texture_buffers.end(), [image_id] (auto &i) { return i.id == image_id; });
@@ -524,6 +542,7 @@ void graphics_renderer_interface::delete_saved_texture(int image_id) {
 }
 
 void graphics_renderer_interface::draw_saved_texture_to_screen(int texture_id, int x, int y, int width, int height) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     buffer_texture* texture_info = get_saved_texture_info(texture_id);
     if (!texture_info) {
@@ -535,6 +554,7 @@ void graphics_renderer_interface::draw_saved_texture_to_screen(int texture_id, i
 }
 
 void graphics_renderer_interface::clear_saved_texture(int texture_id, color clr) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_Texture *former_target = SDL_GetRenderTarget(data.renderer);
     if (!former_target) {
@@ -561,6 +581,7 @@ void graphics_renderer_interface::clear_saved_texture(int texture_id, color clr)
 }
 
 static void create_blend_texture(int type) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_Texture* texture = SDL_CreateTexture(data.renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET, 58, 30);
     if (!texture) {
@@ -637,6 +658,7 @@ static void set_texture_color_and_scale_mode(SDL_Texture *texture, color color,
 }
 
 void graphics_renderer_interface::draw_texture_advanced(const image_t *img, float x, float y, color color, float scale_x, float scale_y, double angle, int disable_coord_scaling) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     if (!img->atlas.p_atlas) {
         return;
@@ -833,6 +855,7 @@ SDL_Window *graphics_renderer_interface::window() {
 }
 
 bool graphics_renderer_interface::save_texture_to_file(const char* filename, SDL_Texture* tex, e_file_format file_format) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_Texture* ren_tex;
     SDL_Surface* surf;
@@ -1052,6 +1075,7 @@ static void destroy_render_texture(void) {
 }
 
 int platform_renderer_create_render_texture(int width, int height) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     destroy_render_texture();
 
@@ -1115,6 +1139,7 @@ int platform_renderer_lost_render_texture() {
 }
 
 void platform_renderer_invalidate_target_textures() {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     if (data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture) {
         SDL_DestroyTexture(data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture);
@@ -1150,6 +1175,7 @@ void platform_renderer_clear() {
 }
 
 void platform_render_apply_filter() {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
 
     if (!platform_render_support_filters()) {
@@ -1189,6 +1215,7 @@ void platform_render_apply_filter() {
 }
 
 void platform_renderer_render() {
+    g_sprite_batch.end_frame();
     OZZY_PROFILER_SECTION("Game/Run/Renderer/Render");
     auto &data = g_renderer_data;
 
@@ -1228,6 +1255,7 @@ void platform_renderer_generate_mouse_cursor_texture(int cursor_id, int size, co
 }
 
 void platform_renderer_pause() {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     SDL_SetRenderTarget(data.renderer, NULL);
 }
@@ -1239,6 +1267,7 @@ void platform_renderer_resume() {
 }
 
 void platform_renderer_destroy(void) {
+    g_sprite_batch.flush();
     auto &data = g_renderer_data;
     destroy_render_texture();
     if (data.renderer) {
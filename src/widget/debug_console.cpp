@@ -3,6 +3,7 @@
 #include "core/custom_span.hpp"
 #include "graphics/screen.h"
 #include "graphics/graphics.h"
+#include "graphics/sprite_batch.h"
 #include "graphics/text.h"
 #include "building/destruction.h"
 #include "game/game.h"
@@ -246,6 +247,7 @@ void game_imgui_overlay_draw() {
     //    return;
     }
 
+    g_sprite_batch.flush();
     ImGui::Render();
     ImGui_ImplSDLRenderer_RenderDrawData(ImGui::GetDrawData());
 }
@@ -4,20 +4,40 @@
 #include "core/profiler.h"
 #include "graphics/graphics.h"
 #include "graphics/view/lookup.h"
+#include "grid/building.h"
 #include "grid/figure.h"
 #include "grid/property.h"
 #include "grid/random.h"
 #include "grid/terrain.h"
 #include "input/scroll.h"
 #include "city/city_buildings.h"
+#include "city/city_figures.h"
 #include "game/game_events.h"
 #include "scenario/scenario.h"
 #include "game/game.h"
 #include "dev/debug.h"
 
+#include <algorithm>
+
 static const color ENEMY_COLOR_BY_CLIMATE[] = {COLOR_MINIMAP_ENEMY_CENTRAL, COLOR_MINIMAP_ENEMY_NORTHERN, COLOR_MINIMAP_ENEMY_DESERT};
 minimap_window g_minimap_window;
 
+// past this many changed tiles one full repaint is cheaper than patching tile by tile
+constexpr size_t MAX_DIRTY_TILES = 4096;
+
+declare_console_command_p(minimap) {
+    std::string args; is >> args;
+
+    if (args == "full") {
+        g_minimap_window.incremental = false;
+    } else if (args == "incremental") {
+        g_minimap_window.incremental = true;
+    }
+    widget_minimap_invalidate();
+
+    os << "minimap update mode: " << (g_minimap_window.incremental ? "incremental" : "full") << std::endl;
+}
+
 template<typename F>
 void city_view_foreach_minimap_tile(int x_offset, int y_offset, int absolute_x, int absolute_y, int width_tiles, int height_tiles, F callback) {
     int odd = 0;
@@ -78,6 +98,15 @@ void minimap_window::on_mission_start() {
     events::subscribe([] (event_rotate_map_reset ev) {
         widget_minimap_invalidate();
     });
+
+    events::subscribe([] (event_advance_day ev) {
+        // full mode repaints the whole map once a day, incremental relies on the marked tiles
+        if (!g_minimap_window.incremental) {
+            widget_minimap_invalidate();
+        }
+    });
+
+    widget_minimap_invalidate();
 }
 
 vec2i minimap_window::get_mouse_relative_pos(const mouse *m, float &xx, float &yy) {
@@ -143,10 +172,17 @@ void minimap_window::draw_foreground(UiFlags flags) {
         refresh_requested = 0;
     } else {
         graphics_draw_from_texture(cached_texture, screen_offset, size);
+        if (!dirty_tiles.empty()) {
+            draw_dirty_tiles();
+            cached_texture = graphics_save_to_texture(cached_texture, screen_offset, size);
+        }
     }
 
     draw_force = false;
 
+    // figures move every tick, they are not part of the cached texture
+    draw_figures();
+
     draw_viewport_rectangle(ctx);
     graphics_reset_clip_rectangle();
 }
@@ -159,6 +195,39 @@ void widget_minimap_invalidate() {
     g_minimap_window.refresh_requested = 1;
 }
 
+void widget_minimap_mark_tile(int grid_offset) {
+    g_minimap_window.mark_dirty(grid_offset);
+}
+
+void minimap_window::mark_dirty(int grid_offset) {
+    if (refresh_requested || !incremental || grid_offset < 0 || grid_offset >= GRID_SIZE_TOTAL) {
+        return;
+    }
+
+    if (dirty_marks.empty()) {
+        dirty_marks.assign(GRID_SIZE_TOTAL, 0);
+    }
+
+    if (dirty_marks[grid_offset]) {
+        return;
+    }
+
+    if (dirty_tiles.size() >= MAX_DIRTY_TILES) {
+        widget_minimap_invalidate();
+        return;
+    }
+
+    dirty_marks[grid_offset] = 1;
+    dirty_tiles.push_back(grid_offset);
+}
+
+void minimap_window::reset_dirty() {
+    for (int grid_offset : dirty_tiles) {
+        dirty_marks[grid_offset] = 0;
+    }
+    dirty_tiles.clear();
+}
+
 void minimap_window::set_bounds(vec2i ds) {
     draw_size = ds;
     size = {2 * ds.x, ds.y};
@@ -187,30 +256,107 @@ void minimap_window::set_bounds(vec2i ds) {
     absolute_tile.set_y( absolute_tile.y() & ~1 );
 }
 
-bool minimap_window::draw_figure(vec2i screen, tile2i point) {
-    int grid_offset = point.grid_offset();
-    int colorype = map_figure_foreach_until(grid_offset, TEST_SEARCH_HAS_COLOR);
-    if (colorype == FIGURE_COLOR_NONE) {
+bool minimap_window::tile_screen_pos(tile2i point, vec2i &screen) {
+    vec2i screen_tile = tile_to_screen(point);
+    if (screen_tile.x < 0) {
+        return false;
+    }
+
+    // same placement as city_view_foreach_minimap_tile()
+    const int x_rel = screen_tile.x - absolute_tile.x();
+    const int y_rel = screen_tile.y - absolute_tile.y();
+    if (x_rel < -4 || x_rel >= draw_size.x || y_rel < -4 || y_rel >= draw_size.y + 4) {
         return false;
     }
 
-    color color = COLOR_MINIMAP_WOLF;
-    switch (color) {
-    case FIGURE_COLOR_SOLDIER:
-        color = COLOR_MINIMAP_SOLDIER;
-        break;
+    const bool odd_row = (y_rel + 4) & 1;
+    screen.x = screen_offset.x - (odd_row ? 9 : 8) + 2 * (x_rel + 4);
+    screen.y = screen_offset.y + y_rel;
+    return true;
+}
+
+void minimap_window::draw_figures() {
+    OZZY_PROFILER_SECTION("Render/Frame/Window/City/Sidebar Expanded/Minimap Figures");
+    for (auto *f : map_figures()) {
+        if (!f->is_valid()) {
+            continue;
+        }
+
+        const e_minimap_figure_color colortype = f->get_figure_color();
+        if (colortype == FIGURE_COLOR_NONE) {
+            continue;
+        }
+
+        vec2i screen;
+        if (!tile_screen_pos(f->tile, screen)) {
+            continue;
+        }
+
+        color clr = COLOR_MINIMAP_WOLF;
+        switch (colortype) {
+        case FIGURE_COLOR_SOLDIER:
+            clr = COLOR_MINIMAP_SOLDIER;
+            break;
+
+        case FIGURE_COLOR_ENEMY:
+            clr = enemy_color;
+            break;
+
+        case FIGURE_COLOR_ANIMAL:
+            clr = COLOR_MINIMAP_ANIMAL;
+            break;
+
+        default:
+            break;
+        }
+
+        graphics_draw_pixel(screen, clr);
+    }
+}
+
+void minimap_window::draw_dirty_tiles() {
+    OZZY_PROFILER_SECTION("Render/Frame/Window/City/Sidebar Expanded/Minimap Dirty Tiles");
+    struct tile_pos_t {
+        vec2i screen;
+        tile2i point;
+    };
+
+    std::vector<tile_pos_t> tiles;
+    tiles.reserve(dirty_tiles.size());
+    auto add_tile = [&] (tile2i point) {
+        vec2i screen;
+        if (tile_screen_pos(point, screen)) {
+            tiles.push_back({screen, point});
+        }
+    };
+
+    for (int grid_offset : dirty_tiles) {
+        // a building is painted from its draw tile over the whole footprint
+        building *b = map_building_at(grid_offset) ? building_at(grid_offset) : nullptr;
+        if (b && b->id && b->size > 1) {
+            for (int dy = 0; dy < b->size; ++dy) {
+                for (int dx = 0; dx < b->size; ++dx) {
+                    add_tile(b->tile.shifted(dx, dy));
+                }
+            }
+        } else {
+            add_tile(tile2i(grid_offset));
+        }
+    }
 
-    case FIGURE_COLOR_ENEMY:
-        color = enemy_color;
-        break;
+    // keep the row by row order of the full pass, images of neighbour tiles overlap
+    std::sort(tiles.begin(), tiles.end(), [] (const tile_pos_t &a, const tile_pos_t &b) {
+        return a.screen.y != b.screen.y ? a.screen.y < b.screen.y : a.screen.x < b.screen.x;
+    });
+    tiles.erase(std::unique(tiles.begin(), tiles.end(), [] (const tile_pos_t &a, const tile_pos_t &b) {
+        return a.point.grid_offset() == b.point.grid_offset();
+    }), tiles.end());
 
-    case FIGURE_COLOR_ANIMAL:
-        color = COLOR_MINIMAP_ANIMAL;
-        break;
+    for (const auto &t : tiles) {
+        draw_minimap_tile(t.screen, t.point);
     }
 
-    graphics_draw_pixel(screen, color);
-    return true;
+    reset_dirty();
 }
 
 void minimap_window::draw_minimap_tile(vec2i screen, tile2i point) {
@@ -223,10 +369,6 @@ void minimap_window::draw_minimap_tile(vec2i screen, tile2i point) {
         return;
     }
 
-    if (draw_figure(screen, point)) {
-        return;
-    }
-
     int terrain = map_terrain_get(grid_offset);
     // exception for fort ground: display as empty land
     if (terrain & TERRAIN_BUILDING) {
@@ -360,6 +502,7 @@ void minimap_window::draw_uncached(vec2i pos) {
     screen_offset = pos;
     enemy_color = ENEMY_COLOR_BY_CLIMATE[scenario_property_climate()];
     draw(UiFlags_None);
+    reset_dirty();
 
     cached_texture = graphics_save_to_texture(cached_texture, screen_offset, size);
 }
@@ -4,6 +4,8 @@
 #include "graphics/animation.h"
 #include "window/autoconfig_window.h"
 
+#include <vector>
+
 struct minimap_window : public autoconfig_window_t<minimap_window> {
     tile2i absolute_tile;
     vec2i draw_size;
@@ -16,6 +18,9 @@ struct minimap_window : public autoconfig_window_t<minimap_window> {
     int refresh_requested;
     bool draw_force = false;
     int cached_texture = 0;
+    bool incremental = true;
+    std::vector<int> dirty_tiles;
+    std::vector<uint8_t> dirty_marks; // grid offset -> already in dirty_tiles
     animation_t terrain_canal;
     animation_t terrain_water;
     animation_t terrain_shrub;
@@ -47,7 +52,11 @@ struct minimap_window : public autoconfig_window_t<minimap_window> {
     virtual void on_mission_start() override;
     
     bool is_in_minimap(const mouse *m);
-    bool draw_figure(vec2i screen, tile2i point);
+    bool tile_screen_pos(tile2i point, vec2i &screen);
+    void mark_dirty(int grid_offset);
+    void reset_dirty();
+    void draw_dirty_tiles();
+    void draw_figures();
     vec2i get_mouse_relative_pos(const mouse *m, float &xx, float &yy);
     void set_bounds(vec2i draw_size);
     void draw_uncached(vec2i offset);
@@ -59,5 +68,7 @@ struct minimap_window : public autoconfig_window_t<minimap_window> {
 
 void widget_minimap_init();
 void widget_minimap_invalidate();
+// the tile look changed (terrain, building), only such tiles are redrawn into the cached texture
+void widget_minimap_mark_tile(int grid_offset);
 void widget_minimap_draw(vec2i offset, int force);
 bool widget_minimap_handle_mouse(const mouse* m);